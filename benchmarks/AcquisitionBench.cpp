@@ -0,0 +1,190 @@
+#include <TripleBuffer.hpp>
+#include <sim/SimBoard.hpp>
+#include <sim/SimClock.hpp>
+
+#include "Benchmarks.hpp"
+
+namespace bench {
+
+namespace {
+
+/** Time the firmware main loop waits after each iteration, see targets/REV3-TMS/main.cpp */
+constexpr uint32_t MAIN_LOOP_WAIT_MS = 1;
+
+/** Simulated time the main loop is run for before the bus load of the adaptive acquisition is counted */
+constexpr uint32_t SETTLE_MS = 5000;
+
+/** Simulated time the bus load of the adaptive acquisition is counted over */
+constexpr uint32_t WINDOW_MS = 10000;
+
+/** Sensor whose temperature moves in the transient benchmark */
+constexpr uint8_t TRANSIENT_SENSOR = 2;
+
+/**
+ * Record the bus activity of a single call as counters
+ *
+ * @param[in] result Result to attach the counters to
+ * @param[in] i2c Bus to read the activity from
+ * @param[in] body Call to account
+ */
+template<typename F>
+void countBusActivity(Result* result, sim::SimI2C& i2c, F&& body) {
+    if (!result) {
+        return;
+    }
+
+    i2c.resetStats();
+    body();
+    const sim::SimI2C::Stats& stats = i2c.stats();
+    result->counter("i2c_transactions", stats.transactions);
+    result->counter("i2c_bytes", stats.bytes);
+    result->counter("i2c_nacks", stats.nacks);
+    result->counter("bus_time_us", static_cast<double>(stats.busTimeUs));
+}
+
+void benchConversion(Suite& suite) {
+    // Sweep the whole raw range so every branch of the conversion is exercised
+    static int16_t raw[1024];
+    for (int i = 0; i < 1024; i++) {
+        raw[i] = static_cast<int16_t>(i * 64 - 32768);
+    }
+
+    suite.measure("tmp117.convert", [] {
+        int32_t sum = 0;
+        for (int16_t value : raw) {
+            sum += TMS::TMP117::toCentiCelsius(value);
+        }
+        doNotOptimize(sum);
+    }, 1024);
+}
+
+void benchPublication(Suite& suite) {
+    // Same layout as the sweeps TMS publishes
+    struct Sweep {
+        uint32_t timeMs;
+        int16_t temps[NUM_TEMP_SENSORS];
+    };
+    static TMS::TripleBuffer<Sweep> sweeps(Sweep{});
+    static uint32_t count = 0;
+
+    suite.measure("sweep.publish", [] {
+        Sweep& sweep = sweeps.back();
+        for (int16_t& temp : sweep.temps) {
+            temp = static_cast<int16_t>(count);
+        }
+        sweep.timeMs = count++;
+        sweeps.publish();
+
+        sweeps.update();
+        doNotOptimize(sweeps.front().temps[0]);
+    });
+}
+
+void benchSweep(Suite& suite) {
+    sim::SimBoard board;
+
+    // Without TMS::process() setting the poll periods again, the sensors stay due on every sweep
+    board.pollEverySensor();
+
+    Result* result = suite.measure("mux.poll_all_devices", [&board] { board.mux.pollAllDevices(); });
+    countBusActivity(result, board.i2c, [&board] { board.mux.pollAllDevices(); });
+}
+
+void benchProcess(Suite& suite, const char* name, CO_MODE mode) {
+    sim::SimBoard board;
+    board.tms.setMode(mode);
+
+    // Every call is a full sweep, the cost of the adaptive acquisition is measured by benchAdaptive()
+    auto sweep = [&board] {
+        board.pollEverySensor();
+        board.tms.process();
+    };
+    Result* result = suite.measure(name, sweep);
+    countBusActivity(result, board.i2c, sweep);
+}
+
+/**
+ * The main loop of the board, with one sensor swinging between two temperatures at a fixed rate
+ */
+class MainLoop {
+public:
+    /**
+     * @param[in] ratePerS Rate the transient sensor moves at in degrees celsius per second, 0 for steady state
+     */
+    explicit MainLoop(double ratePerS) : ratePerS(ratePerS) {
+        board.tms.setMode(CO_OPERATIONAL);
+    }
+
+    /**
+     * Run one iteration of the main loop
+     */
+    void iterate() {
+        if (ratePerS != 0) {
+            celsius += rising ? ratePerS * MAIN_LOOP_WAIT_MS / 1000 : -ratePerS * MAIN_LOOP_WAIT_MS / 1000;
+            rising = rising ? celsius < HIGH_CELSIUS : celsius <= LOW_CELSIUS;
+            board.simSensors[TRANSIENT_SENSOR].setTemperature(celsius);
+        }
+        board.tms.process();
+        board.tms.updatePDOTemps();
+        core::time::wait(MAIN_LOOP_WAIT_MS);
+    }
+
+    /**
+     * Run the main loop for a span of simulated time
+     *
+     * @param[in] ms Simulated time to run for
+     */
+    void run(uint32_t ms) {
+        for (uint32_t i = 0; i < ms / MAIN_LOOP_WAIT_MS; i++) {
+            iterate();
+        }
+    }
+
+    sim::SimBoard board;
+
+private:
+    /** Range the transient sensor swings over */
+    static constexpr double LOW_CELSIUS  = 30;
+    static constexpr double HIGH_CELSIUS = 60;
+
+    double ratePerS;
+    double celsius = LOW_CELSIUS;
+    bool rising    = true;
+};
+
+void benchAdaptive(Suite& suite, const char* name, double ratePerS) {
+    MainLoop timed(ratePerS);
+    Result* result = suite.measure(name, [&timed] { timed.iterate(); });
+    if (!result) {
+        return;
+    }
+
+    // Count on a fresh board from a reset clock, so the counters do not depend on how long the timing ran
+    sim::SimClock::reset();
+    MainLoop counted(ratePerS);
+    counted.run(SETTLE_MS);
+    counted.board.i2c.resetStats();
+    uint64_t start = sim::SimClock::micros();
+    counted.run(WINDOW_MS);
+
+    const sim::SimI2C::Stats& stats = counted.board.i2c.stats();
+    double seconds                  = static_cast<double>(sim::SimClock::micros() - start) / 1e6;
+    result->counter("i2c_transactions_per_s", static_cast<double>(stats.transactions) / seconds);
+    result->counter("bus_load_pct", static_cast<double>(stats.busTimeUs) / (seconds * 1e6) * 100.0);
+}
+
+} // namespace
+
+void runAcquisitionBenchmarks(Suite& suite) {
+    sim::SimClock::reset();
+
+    benchConversion(suite);
+    benchPublication(suite);
+    benchSweep(suite);
+    benchProcess(suite, "tms.process.preop", CO_PREOP);
+    benchProcess(suite, "tms.process.operational", CO_OPERATIONAL);
+    benchAdaptive(suite, "tms.acquisition.steady", 0);
+    benchAdaptive(suite, "tms.acquisition.transient", 2);
+}
+
+} // namespace bench
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ostream>
+
+#include "Benchmark.hpp"
+
+namespace bench {
+
+uint64_t nowNs() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+void Result::counter(const std::string& counterName, double value) {
+    for (auto& existing : counters) {
+        if (existing.first == counterName) {
+            existing.second = value;
+            return;
+        }
+    }
+    counters.emplace_back(counterName, value);
+}
+
+Suite::Suite(double minTimeMs, std::string filter, std::string buildType)
+    : minTimeNs(static_cast<uint64_t>(minTimeMs * 1e6)), filter(std::move(filter)), buildType(std::move(buildType)) {}
+
+bool Suite::enabled(const std::string& name) const {
+    return filter.empty() || name.find(filter) != std::string::npos;
+}
+
+Result* Suite::record(const std::string& name, uint64_t iterations, std::vector<double>& samples) {
+    std::sort(samples.begin(), samples.end());
+
+    for (Result& existing : results) {
+        if (existing.name == name) {
+            if (samples.front() < existing.nsPerOp) {
+                existing.iterations = iterations;
+                existing.nsPerOp    = samples.front();
+            }
+            return &existing;
+        }
+    }
+
+    Result result;
+    result.name       = name;
+    result.iterations = iterations;
+    result.nsPerOp    = samples.front();
+    results.push_back(result);
+    return &results.back();
+}
+
+void Suite::print(std::ostream& out) const {
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-40s %14s %14s\n", "benchmark", "ns/op", "iterations");
+    out << line;
+
+    for (const Result& result : results) {
+        std::snprintf(line,
+                      sizeof(line),
+                      "%-40s %14.2f %14llu\n",
+                      result.name.c_str(),
+                      result.nsPerOp,
+                      static_cast<unsigned long long>(result.iterations));
+        out << line;
+        for (const auto& counter : result.counters) {
+            std::snprintf(line, sizeof(line), "    %-36s %14.2f\n", counter.first.c_str(), counter.second);
+            out << line;
+        }
+    }
+}
+
+void Suite::writeJson(std::ostream& out) const {
+    char number[32];
+
+    out << "{\n  \"build_type\": " << Json::quote(buildType) << ",\n";
+    out << "  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& result = results[i];
+
+        std::snprintf(number, sizeof(number), "%.3f", result.nsPerOp);
+        out << (i ? ",\n" : "\n") << "    {\n";
+        out << "      \"name\": " << Json::quote(result.name) << ",\n";
+        out << "      \"iterations\": " << result.iterations << ",\n";
+        out << "      \"ns_per_op\": " << number << ",\n";
+        out << "      \"counters\": {";
+        for (size_t j = 0; j < result.counters.size(); j++) {
+            std::snprintf(number, sizeof(number), "%.3f", result.counters[j].second);
+            out << (j ? ", " : "") << Json::quote(result.counters[j].first) << ": " << number;
+        }
+        out << "}\n    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+bool Suite::comparable(const Json& baseline, std::ostream& report) const {
+    const Json* baseType = baseline.find("build_type");
+    if (!baseType || baseType->type != Json::Type::STRING) {
+        report << "baseline does not record its build type, regenerate it with bench-baseline\n";
+        return false;
+    }
+    if (baseType->string != buildType) {
+        report << "baseline was recorded from a " << Json::quote(baseType->string) << " build, this is a "
+               << Json::quote(buildType) << " build; configure with -DCMAKE_BUILD_TYPE=" << baseType->string
+               << " or regenerate the baseline\n";
+        return false;
+    }
+    return true;
+}
+
+int Suite::compare(const Json& baseline, double timeThreshold, double counterThreshold, std::ostream& report) const {
+    const Json* entries = baseline.find("benchmarks");
+    if (!entries || entries->type != Json::Type::ARRAY) {
+        report << "baseline has no \"benchmarks\" array\n";
+        return 1;
+    }
+
+    int regressions = 0;
+    char line[200];
+
+    auto check = [&](const std::string& what, double base, double now, double threshold) {
+        // Values are stored with three decimals, so allow for the rounding on top of the threshold
+        double limit   = base * (1.0 + threshold) + 0.0005;
+        bool regressed = now > limit;
+        std::snprintf(line,
+                      sizeof(line),
+                      "%-4s %-52s base %12.3f  now %12.3f  (%+.1f%%)\n",
+                      regressed ? "FAIL" : "ok",
+                      what.c_str(),
+                      base,
+                      now,
+                      base > 0 ? (now - base) / base * 100.0 : 0.0);
+        report << line;
+        if (regressed) {
+            regressions++;
+        }
+    };
+
+    for (const Result& result : results) {
+        const Json* base = nullptr;
+        for (const Json& entry : entries->array) {
+            const Json* name = entry.find("name");
+            if (name && name->string == result.name) {
+                base = &entry;
+                break;
+            }
+        }
+        if (!base) {
+            report << "new  " << result.name << " (not in baseline)\n";
+            continue;
+        }
+
+        const Json* nsPerOp = base->find("ns_per_op");
+        if (nsPerOp && nsPerOp->type == Json::Type::NUMBER) {
+            check(result.name + " ns/op", nsPerOp->number, result.nsPerOp, timeThreshold);
+        }
+
+        const Json* counters = base->find("counters");
+        for (const auto& counter : result.counters) {
+            const Json* baseCounter = counters ? counters->find(counter.first) : nullptr;
+            if (!baseCounter || baseCounter->type != Json::Type::NUMBER) {
+                report << "new  " << result.name << " " << counter.first << " (not in baseline)\n";
+                continue;
+            }
+            check(result.name + " " + counter.first, baseCounter->number, counter.second, counterThreshold);
+        }
+    }
+
+    return regressions;
+}
+
+} // namespace bench
@@ -0,0 +1,187 @@
+#ifndef TMS_BENCH_BENCHMARK_HPP
+#define TMS_BENCH_BENCHMARK_HPP
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Json.hpp"
+
+namespace bench {
+
+/**
+ * Read a monotonic clock. Kept out of line so that <chrono> is not pulled into translation units that include the
+ * firmware headers, whose global time namespace alias clashes with ::time().
+ *
+ * @return Monotonic time in nanoseconds
+ */
+uint64_t nowNs();
+
+/**
+ * Keep the compiler from discarding a value computed by a benchmark body
+ *
+ * @param[in] value Value to keep alive
+ */
+template<typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Measurement of a single benchmark. Counters are deterministic quantities (bus transactions, modeled bus time, ...)
+ * where lower is better, so they can be held to a tighter threshold than wall-clock time.
+ */
+struct Result {
+    /** Dotted benchmark name, e.g. "mux.poll_all_devices" */
+    std::string name;
+    /** Iterations per timed repetition */
+    uint64_t iterations = 0;
+    /** Fastest wall-clock time per iteration over the repetitions */
+    double nsPerOp = 0;
+    /** Named deterministic counters */
+    std::vector<std::pair<std::string, double>> counters;
+
+    /**
+     * Record a counter value, replacing any earlier value of the same counter
+     *
+     * @param[in] counterName Name of the counter
+     * @param[in] value Value of the counter
+     */
+    void counter(const std::string& counterName, double value);
+};
+
+/**
+ * Runs benchmarks, collects their results, and checks them against a stored baseline
+ */
+class Suite {
+public:
+    /**
+     * Construct a suite
+     *
+     * @param[in] minTimeMs Minimum wall-clock time of each timed repetition
+     * @param[in] filter Only benchmarks whose name contains this string are run
+     * @param[in] buildType Build type the benchmarks were compiled with
+     */
+    Suite(double minTimeMs, std::string filter, std::string buildType);
+
+    /**
+     * Time a benchmark body. The iteration count is grown until a repetition takes at least the minimum time, then
+     * the fastest of several repetitions is reported, since interference from the host only ever adds time. Measuring
+     * the same name again keeps the faster of the two results.
+     *
+     * @param[in] name Benchmark name
+     * @param[in] body Callable run once per iteration
+     * @param[in] opsPerCall Number of operations each call of the body performs, times are reported per operation
+     * @return The recorded result for attaching counters, or nullptr if the benchmark was filtered out
+     */
+    template<typename F>
+    Result* measure(const std::string& name, F&& body, uint32_t opsPerCall = 1);
+
+    /**
+     * Check whether a benchmark would be run
+     *
+     * @param[in] name Benchmark name
+     * @return Whether the name passes the filter
+     */
+    bool enabled(const std::string& name) const;
+
+    /**
+     * Print a human readable table of the results
+     *
+     * @param[out] out Stream to print to
+     */
+    void print(std::ostream& out) const;
+
+    /**
+     * Write the results as JSON. The same format is read back as a baseline.
+     *
+     * @param[out] out Stream to write to
+     */
+    void writeJson(std::ostream& out) const;
+
+    /**
+     * Check that a baseline was recorded from the same build type as this suite. Timings of builds with different
+     * optimization are not comparable.
+     *
+     * @param[in] baseline Baseline document produced by writeJson()
+     * @param[out] report Stream a mismatch is printed to
+     * @return Whether the baseline can be compared against
+     */
+    bool comparable(const Json& baseline, std::ostream& report) const;
+
+    /**
+     * Compare the results against a baseline. Benchmarks or counters missing from either side are reported but do
+     * not count as regressions.
+     *
+     * @param[in] baseline Baseline document produced by writeJson()
+     * @param[in] timeThreshold Allowed relative increase in time per iteration
+     * @param[in] counterThreshold Allowed relative increase in each counter
+     * @param[out] report Stream the comparison is printed to
+     * @return Number of regressions found
+     */
+    int compare(const Json& baseline, double timeThreshold, double counterThreshold, std::ostream& report) const;
+
+private:
+    /** Number of timed repetitions the fastest is taken from */
+    static constexpr int REPETITIONS = 7;
+
+    /** Minimum wall-clock time of each repetition in nanoseconds */
+    uint64_t minTimeNs;
+
+    /** Name filter */
+    std::string filter;
+
+    /** Build type the benchmarks were compiled with */
+    std::string buildType;
+
+    /** Results in the order they were run */
+    std::vector<Result> results;
+
+    /**
+     * Store a finished measurement
+     *
+     * @param[in] name Benchmark name
+     * @param[in] iterations Iterations per repetition
+     * @param[in] samples Time per iteration of each repetition
+     * @return The stored result
+     */
+    Result* record(const std::string& name, uint64_t iterations, std::vector<double>& samples);
+};
+
+template<typename F>
+Result* Suite::measure(const std::string& name, F&& body, uint32_t opsPerCall) {
+    if (!enabled(name)) {
+        return nullptr;
+    }
+
+    // Grow the iteration count until one repetition is long enough to time reliably
+    uint64_t iterations = 1;
+    while (true) {
+        uint64_t start = nowNs();
+        for (uint64_t i = 0; i < iterations; i++) {
+            body();
+        }
+        uint64_t elapsed = nowNs() - start;
+        if (elapsed >= minTimeNs || iterations >= (1ull << 32)) {
+            break;
+        }
+        iterations *= elapsed < minTimeNs / 100 ? 10 : 2;
+    }
+
+    std::vector<double> samples;
+    for (int rep = 0; rep < REPETITIONS; rep++) {
+        uint64_t start = nowNs();
+        for (uint64_t i = 0; i < iterations; i++) {
+            body();
+        }
+        samples.push_back(static_cast<double>(nowNs() - start) / static_cast<double>(iterations * opsPerCall));
+    }
+
+    return record(name, iterations, samples);
+}
+
+} // namespace bench
+
+#endif // TMS_BENCH_BENCHMARK_HPP
@@ -0,0 +1,33 @@
+#ifndef TMS_BENCH_BENCHMARKS_HPP
+#define TMS_BENCH_BENCHMARKS_HPP
+
+#include "Benchmark.hpp"
+
+namespace bench {
+
+/**
+ * TMP117 conversion, publishing a sweep, TCA954MUX sweeps, TMS::process() in each NMT mode, and the bus load of the
+ * adaptive acquisition at steady state and with a sensor moving 2 degrees celsius per second
+ *
+ * @param[in] suite Suite to run in
+ */
+void runAcquisitionBenchmarks(Suite& suite);
+
+/**
+ * CAN RX queue throughput, decoding of the DBC messages and object dictionary lookups
+ *
+ * @param[in] suite Suite to run in
+ */
+void runCANBenchmarks(Suite& suite);
+
+/**
+ * Sweep cost and bus load of the sensor networks of NUM_TEMP_SENSORS TMP117s: 8 on one mux, 16 on one mux, or 32 both
+ * on two muxes and on cascaded muxes
+ *
+ * @param[in] suite Suite to run in
+ */
+void runScalingBenchmarks(Suite& suite);
+
+} // namespace bench
+
+#endif // TMS_BENCH_BENCHMARKS_HPP
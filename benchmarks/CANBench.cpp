@@ -0,0 +1,197 @@
+#include <vector>
+
+#include <TMS.hpp>
+#include <sim/SimBoard.hpp>
+
+#include "Benchmarks.hpp"
+
+namespace bench {
+
+namespace {
+
+/** Receive queue type used by the firmware's CAN interrupt */
+using CANQueue = core::types::FixedQueue<CANOPEN_QUEUE_SIZE, io::CANMessage>;
+
+/**
+ * Bisection over the dictionary keys, as CODictFind() does in the CANopen stack
+ *
+ * @param[in] dictionary Sorted dictionary
+ * @param[in] numElements Number of entries before the end marker
+ * @param[in] key Index and sub-index to find, flags ignored
+ * @param[out] probes Number of entries compared
+ * @return The entry, or nullptr if not found
+ */
+CO_OBJ_T* bisect(CO_OBJ_T* dictionary, uint16_t numElements, uint32_t key, uint32_t& probes) {
+    int32_t start = 0;
+    int32_t end   = numElements - 1;
+
+    while (start <= end) {
+        int32_t center = start + (end - start) / 2;
+        uint32_t found = CO_GET_DEV(dictionary[center].Key);
+        probes++;
+
+        if (found == CO_GET_DEV(key)) {
+            return &dictionary[center];
+        }
+        if (found > CO_GET_DEV(key)) {
+            end = center - 1;
+        } else {
+            start = center + 1;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Linear scan over the dictionary keys
+ *
+ * @param[in] dictionary Dictionary to search
+ * @param[in] numElements Number of entries before the end marker
+ * @param[in] key Index and sub-index to find, flags ignored
+ * @param[out] probes Number of entries compared
+ * @return The entry, or nullptr if not found
+ */
+CO_OBJ_T* scan(CO_OBJ_T* dictionary, uint16_t numElements, uint32_t key, uint32_t& probes) {
+    for (uint16_t i = 0; i < numElements; i++) {
+        probes++;
+        if (CO_GET_DEV(dictionary[i].Key) == CO_GET_DEV(key)) {
+            return &dictionary[i];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Synthetic dictionary shaped like the board's: objects with four contiguous sub-indices each
+ */
+struct SyntheticDictionary {
+    explicit SyntheticDictionary(uint16_t numElements) : numElements(numElements), entries(numElements + 1) {
+        for (uint16_t i = 0; i < numElements; i++) {
+            entries[i].Key  = CO_KEY(0x2000 + i / 4, i % 4, CO_OBJ_D___R_);
+            entries[i].Type = CO_TUNSIGNED16;
+            entries[i].Data = 0;
+        }
+        entries[numElements] = CO_OBJ_DICT_ENDMARK;
+
+        // Look the keys up in a fixed pseudo-random order so neither search gets a predictable pattern
+        uint32_t state = 0x2545F491;
+        for (uint16_t i = 0; i < numElements; i++) {
+            state = state * 1664525 + 1013904223;
+            order.push_back(entries[state % numElements].Key);
+        }
+    }
+
+    uint16_t numElements;
+    std::vector<CO_OBJ_T> entries;
+    std::vector<uint32_t> order;
+};
+
+/**
+ * Compare lookup strategies on a synthetic dictionary
+ *
+ * @tparam NUM_ELEMENTS Dictionary size
+ * @param[in] suite Suite to run in
+ */
+template<uint16_t NUM_ELEMENTS>
+void benchLookupStrategies(Suite& suite) {
+    static SyntheticDictionary od(NUM_ELEMENTS);
+
+    std::string size = std::to_string(NUM_ELEMENTS);
+    uint32_t probes  = 0;
+
+    Result* result = suite.measure("od.lookup.linear." + size, [&] {
+        for (uint32_t key : od.order) {
+            doNotOptimize(scan(od.entries.data(), od.numElements, key, probes));
+        }
+    }, od.numElements);
+    if (result) {
+        probes = 0;
+        for (uint32_t key : od.order) {
+            scan(od.entries.data(), od.numElements, key, probes);
+        }
+        result->counter("avg_probes", static_cast<double>(probes) / od.numElements);
+    }
+
+    result = suite.measure("od.lookup.bisect." + size, [&] {
+        for (uint32_t key : od.order) {
+            doNotOptimize(bisect(od.entries.data(), od.numElements, key, probes));
+        }
+    }, od.numElements);
+    if (result) {
+        probes = 0;
+        for (uint32_t key : od.order) {
+            bisect(od.entries.data(), od.numElements, key, probes);
+        }
+        result->counter("avg_probes", static_cast<double>(probes) / od.numElements);
+    }
+}
+
+void benchRxQueue(Suite& suite) {
+    static CANQueue queue;
+    uint8_t payload[8] = {0x2F, 0x00, 0x22, 0x01, 0x32, 0x00, 0x00, 0x00};
+    io::CANMessage message(0x602, 8, payload, false);
+
+    // Fill the queue from the interrupt handler and drain it as the CANopen driver would
+    suite.measure("can.rx_queue", [&message] {
+        for (int i = 0; i < CANOPEN_QUEUE_SIZE; i++) {
+            TMS::TMS::canInterrupt(message, &queue);
+        }
+
+        io::CANMessage received;
+        while (queue.pop(&received)) {
+            doNotOptimize(received);
+        }
+    }, CANOPEN_QUEUE_SIZE);
+}
+
+void benchDBCUnpack(Suite& suite) {
+    // One payload per generated message, decoded the way tms-decode does
+    uint8_t payloads[TMS::can::NUM_MESSAGES][8] = {};
+    TMS::can::TEMP1_TPDO temps;
+    temps.TEMP1_TPDOBoard = 2500;
+    temps.TEMP1_TPDOT0    = -1234;
+    temps.pack(payloads[1]);
+    int64_t raw[64];
+
+    suite.measure("can.dbc.unpack", [&] {
+        for (uint8_t i = 0; i < TMS::can::NUM_MESSAGES; i++) {
+            TMS::can::MESSAGES[i].unpackRaw(payloads[i], raw);
+            doNotOptimize(raw);
+        }
+    }, TMS::can::NUM_MESSAGES);
+}
+
+void benchDictionaryLookup(Suite& suite) {
+    sim::SimBoard board;
+    CO_OBJ_T* dictionary = board.tms.getObjectDictionary();
+    uint16_t numElements = board.tms.getNumElements();
+    uint32_t probes      = 0;
+
+    Result* result = suite.measure("od.find", [&] {
+        for (uint16_t i = 0; i < numElements; i++) {
+            doNotOptimize(bisect(dictionary, numElements, dictionary[i].Key, probes));
+        }
+    }, numElements);
+    if (!result) {
+        return;
+    }
+
+    probes = 0;
+    for (uint16_t i = 0; i < numElements; i++) {
+        bisect(dictionary, numElements, dictionary[i].Key, probes);
+    }
+    result->counter("avg_probes", static_cast<double>(probes) / numElements);
+}
+
+} // namespace
+
+void runCANBenchmarks(Suite& suite) {
+    benchRxQueue(suite);
+    benchDBCUnpack(suite);
+    benchDictionaryLookup(suite);
+    benchLookupStrategies<64>(suite);
+    benchLookupStrategies<256>(suite);
+    benchLookupStrategies<1024>(suite);
+}
+
+} // namespace bench
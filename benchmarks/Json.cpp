@@ -0,0 +1,250 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include "Json.hpp"
+
+namespace bench {
+
+namespace {
+
+/**
+ * Recursive descent parser over a JSON document
+ */
+class Parser {
+public:
+    explicit Parser(const std::string& text) : text(text) {}
+
+    bool document(Json& out) {
+        if (!value(out)) {
+            return false;
+        }
+        skipSpace();
+        if (pos != text.size()) {
+            return fail("trailing characters");
+        }
+        return true;
+    }
+
+    std::string error;
+
+private:
+    const std::string& text;
+    size_t pos = 0;
+
+    bool fail(const char* message) {
+        if (error.empty()) {
+            error = std::string(message) + " at offset " + std::to_string(pos);
+        }
+        return false;
+    }
+
+    void skipSpace() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) {
+            pos++;
+        }
+    }
+
+    bool literal(const char* word) {
+        size_t length = std::char_traits<char>::length(word);
+        if (text.compare(pos, length, word) != 0) {
+            return fail("unexpected token");
+        }
+        pos += length;
+        return true;
+    }
+
+    bool value(Json& out) {
+        skipSpace();
+        if (pos >= text.size()) {
+            return fail("unexpected end of input");
+        }
+
+        switch (text[pos]) {
+        case '{':
+            return object(out);
+        case '[':
+            return array(out);
+        case '"':
+            out.type = Json::Type::STRING;
+            return string(out.string);
+        case 't':
+            out.type    = Json::Type::BOOL;
+            out.boolean = true;
+            return literal("true");
+        case 'f':
+            out.type    = Json::Type::BOOL;
+            out.boolean = false;
+            return literal("false");
+        case 'n':
+            out.type = Json::Type::NUL;
+            return literal("null");
+        default:
+            return number(out);
+        }
+    }
+
+    bool number(Json& out) {
+        const char* start = text.c_str() + pos;
+        char* end         = nullptr;
+        out.number        = std::strtod(start, &end);
+        if (end == start) {
+            return fail("expected a value");
+        }
+        out.type = Json::Type::NUMBER;
+        pos += static_cast<size_t>(end - start);
+        return true;
+    }
+
+    bool string(std::string& out) {
+        // Opening quote
+        pos++;
+        out.clear();
+        while (pos < text.size() && text[pos] != '"') {
+            char c = text[pos++];
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos >= text.size()) {
+                break;
+            }
+            char escaped = text[pos++];
+            switch (escaped) {
+            case 'n':
+                out += '\n';
+                break;
+            case 't':
+                out += '\t';
+                break;
+            case 'r':
+                out += '\r';
+                break;
+            case 'u':
+                // Only the ASCII range is needed for benchmark names
+                if (pos + 4 > text.size()) {
+                    return fail("truncated escape");
+                }
+                out += static_cast<char>(std::strtol(text.substr(pos, 4).c_str(), nullptr, 16));
+                pos += 4;
+                break;
+            default:
+                out += escaped;
+            }
+        }
+        if (pos >= text.size()) {
+            return fail("unterminated string");
+        }
+        // Closing quote
+        pos++;
+        return true;
+    }
+
+    bool array(Json& out) {
+        out.type = Json::Type::ARRAY;
+        pos++;
+        skipSpace();
+        if (pos < text.size() && text[pos] == ']') {
+            pos++;
+            return true;
+        }
+        while (true) {
+            out.array.emplace_back();
+            if (!value(out.array.back())) {
+                return false;
+            }
+            skipSpace();
+            if (pos < text.size() && text[pos] == ',') {
+                pos++;
+            } else if (pos < text.size() && text[pos] == ']') {
+                pos++;
+                return true;
+            } else {
+                return fail("expected ',' or ']'");
+            }
+        }
+    }
+
+    bool object(Json& out) {
+        out.type = Json::Type::OBJECT;
+        pos++;
+        skipSpace();
+        if (pos < text.size() && text[pos] == '}') {
+            pos++;
+            return true;
+        }
+        while (true) {
+            skipSpace();
+            if (pos >= text.size() || text[pos] != '"') {
+                return fail("expected a member name");
+            }
+            out.object.emplace_back();
+            if (!string(out.object.back().first)) {
+                return false;
+            }
+            skipSpace();
+            if (pos >= text.size() || text[pos] != ':') {
+                return fail("expected ':'");
+            }
+            pos++;
+            if (!value(out.object.back().second)) {
+                return false;
+            }
+            skipSpace();
+            if (pos < text.size() && text[pos] == ',') {
+                pos++;
+            } else if (pos < text.size() && text[pos] == '}') {
+                pos++;
+                return true;
+            } else {
+                return fail("expected ',' or '}'");
+            }
+        }
+    }
+};
+
+} // namespace
+
+const Json* Json::find(const std::string& key) const {
+    for (const auto& member : object) {
+        if (member.first == key) {
+            return &member.second;
+        }
+    }
+    return nullptr;
+}
+
+bool Json::parse(const std::string& text, Json& out, std::string& error) {
+    Parser parser(text);
+    out = Json();
+    bool ok = parser.document(out);
+    error   = parser.error;
+    return ok;
+}
+
+std::string Json::quote(const std::string& value) {
+    std::string out = "\"";
+    for (char c : value) {
+        switch (c) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[7];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out += escaped;
+            } else {
+                out += c;
+            }
+        }
+    }
+    return out + "\"";
+}
+
+} // namespace bench
@@ -0,0 +1,59 @@
+#ifndef TMS_BENCH_JSON_HPP
+#define TMS_BENCH_JSON_HPP
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+/**
+ * Minimal JSON document model, enough to read back benchmark results and baselines
+ */
+struct Json {
+    enum class Type {
+        NUL,
+        BOOL,
+        NUMBER,
+        STRING,
+        ARRAY,
+        OBJECT,
+    };
+
+    Type type = Type::NUL;
+    bool boolean = false;
+    double number = 0;
+    std::string string;
+    std::vector<Json> array;
+    std::vector<std::pair<std::string, Json>> object;
+
+    /**
+     * Look up a member of an object
+     *
+     * @param[in] key Member name
+     * @return The member, or nullptr if this is not an object or has no such member
+     */
+    const Json* find(const std::string& key) const;
+
+    /**
+     * Parse a JSON document
+     *
+     * @param[in] text Document text
+     * @param[out] out Parsed document
+     * @param[out] error Description of the first syntax error
+     * @return Whether the document was parsed
+     */
+    static bool parse(const std::string& text, Json& out, std::string& error);
+
+    /**
+     * Quote and escape a string for output
+     *
+     * @param[in] value String to escape
+     * @return The quoted string
+     */
+    static std::string quote(const std::string& value);
+};
+
+} // namespace bench
+
+#endif // TMS_BENCH_JSON_HPP
@@ -0,0 +1,219 @@
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <TMS.hpp>
+#include <dev/TCA954MUX.hpp>
+#include <dev/TMP117.hpp>
+#include <sim/SimI2C.hpp>
+#include <sim/SimPWM.hpp>
+#include <sim/SimTCA954MUX.hpp>
+#include <sim/SimTMP117.hpp>
+
+#include "Benchmarks.hpp"
+
+namespace bench {
+
+namespace {
+
+/** Time the firmware main loop waits after each iteration, see targets/REV3-TMS/main.cpp */
+constexpr double MAIN_LOOP_WAIT_US = 1000;
+
+/**
+ * Sensor network built from TCA9545As and TMP117s, driven through TMS::process(). The network has to have exactly
+ * NUM_TEMP_SENSORS sensors, so TMS manages every one of them.
+ */
+class Topology {
+public:
+    Topology()
+        : i2c(TMS::TMS::TEMP_SCL, TMS::TMS::TEMP_SDA),
+          pumpPWM{sim::SimPWM(TMS::TMS::PUMP1_PWM), sim::SimPWM(TMS::TMS::PUMP2_PWM)},
+          pumps{TMS::Pump(pumpPWM[0]), TMS::Pump(pumpPWM[1])} {}
+
+    /**
+     * Add a TCA9545A. Its leading buses each carry sensorsPerBus TMP117s, and its last nestedBuses buses each carry a
+     * cascaded TCA9545A with nestedSensorsPerBus TMP117s on every bus.
+     *
+     * @param[in] segment Bus segment the mux is attached to
+     * @param[in] sensorsPerBus TMP117s on each directly populated bus, at most 4 (addresses 0x48-0x4B)
+     * @param[in] nestedBuses Number of buses carrying a cascaded mux
+     * @param[in] nestedSensorsPerBus TMP117s on each bus of the cascaded muxes
+     * @return The firmware driver for the mux
+     */
+    TMS::TCA954MUX* addMux(sim::SimI2CSegment& segment, uint8_t sensorsPerBus, uint8_t nestedBuses = 0,
+                           uint8_t nestedSensorsPerBus = 0) {
+        simMuxes.emplace_back(nextMuxAddress++, I2C_MUX_BUS_SIZE);
+        sim::SimTCA954MUX& simMux = simMuxes.back();
+        segment.attach(simMux);
+
+        busLists.emplace_back(I2C_MUX_BUS_SIZE);
+        std::vector<std::vector<TMS::I2CDevice*>>& busList = busLists.back();
+
+        for (uint8_t bus = 0; bus < I2C_MUX_BUS_SIZE; bus++) {
+            if (bus >= I2C_MUX_BUS_SIZE - nestedBuses) {
+                busList[bus].push_back(addMux(simMux.channel(bus), nestedSensorsPerBus));
+                continue;
+            }
+            for (uint8_t i = 0; i < sensorsPerBus; i++) {
+                busList[bus].push_back(addSensor(simMux.channel(bus), 0x48 + i));
+            }
+        }
+
+        busPointers.emplace_back();
+        counts.emplace_back();
+        for (uint8_t bus = 0; bus < I2C_MUX_BUS_SIZE; bus++) {
+            busPointers.back().push_back(busList[bus].data());
+            counts.back().push_back(static_cast<uint8_t>(busList[bus].size()));
+        }
+
+        muxes.emplace_back(i2c, simMux.address, busPointers.back().data(), counts.back().data());
+        return &muxes.back();
+    }
+
+    /**
+     * Create the TMS instance polling the given muxes on the main bus
+     *
+     * @param[in] roots Muxes on the main bus
+     */
+    void start(std::vector<TMS::TCA954MUX*> roots) {
+        if (sensors.size() != NUM_TEMP_SENSORS) {
+            mismatch();
+        }
+        this->roots = roots;
+
+        for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+            sensorPointers[i] = &sensors[i];
+        }
+        tms.emplace_back(temps, sensorPointers, this->roots.data(), static_cast<uint8_t>(this->roots.size()), pumps);
+    }
+
+    /**
+     * Make every sensor due, so the next sweep reads all of them as it would without adaptive acquisition
+     */
+    void pollEverySensor() {
+        for (TMS::TMP117& sensor : sensors) {
+            sensor.setPollPeriod(0);
+        }
+    }
+
+    /**
+     * Count the sensors whose driver did not read back the simulated temperature
+     *
+     * @return Number of wrong readings
+     */
+    uint32_t badReadings() const {
+        uint32_t bad = 0;
+        for (size_t i = 0; i < simSensors.size(); i++) {
+            if (temps[i] != TMS::TMP117::toCentiCelsius(static_cast<int16_t>(simSensors[i].reg(0)))) {
+                bad++;
+            }
+        }
+        return bad;
+    }
+
+    /** Main I2C bus */
+    sim::SimI2C i2c;
+
+    /** Board under test, created by start() */
+    std::deque<TMS::TMS> tms;
+
+private:
+    TMS::I2CDevice* addSensor(sim::SimI2CSegment& segment, uint8_t address) {
+        if (sensors.size() == NUM_TEMP_SENSORS) {
+            mismatch();
+        }
+
+        // Give every sensor a distinct temperature so crossed wires show up as bad readings
+        simSensors.emplace_back(address, 20.0 + static_cast<double>(simSensors.size()));
+        segment.attach(simSensors.back());
+
+        sensors.emplace_back(&i2c, address, &temps[sensors.size()]);
+        return &sensors.back();
+    }
+
+    /**
+     * Stop the run, a network that does not match the build would leave sensors out of TMS
+     */
+    [[noreturn]] static void mismatch() {
+        std::fprintf(stderr, "The network does not have the %d sensors TMS was built for\n", NUM_TEMP_SENSORS);
+        std::exit(2);
+    }
+
+    uint8_t nextMuxAddress = 0x70;
+    sim::SimPWM pumpPWM[2];
+    TMS::Pump pumps[2];
+
+    std::deque<sim::SimTCA954MUX> simMuxes;
+    std::deque<sim::SimTMP117> simSensors;
+    std::deque<TMS::TMP117> sensors;
+    std::deque<TMS::TCA954MUX> muxes;
+    std::deque<std::vector<std::vector<TMS::I2CDevice*>>> busLists;
+    std::deque<std::vector<TMS::I2CDevice**>> busPointers;
+    std::deque<std::vector<uint8_t>> counts;
+    std::vector<TMS::TCA954MUX*> roots;
+    TMS::TMP117* sensorPointers[NUM_TEMP_SENSORS] = {};
+    int16_t temps[NUM_TEMP_SENSORS] = {};
+};
+
+void benchTopology(Suite& suite, const std::string& name, Topology& topology) {
+    TMS::TMS& tms = topology.tms.front();
+
+    // Sweep every sensor on each call, the sweep cost is what grows with the network
+    auto sweep = [&topology, &tms] {
+        topology.pollEverySensor();
+        tms.process();
+    };
+    Result* result = suite.measure(name, sweep);
+    if (!result) {
+        return;
+    }
+
+    topology.i2c.resetStats();
+    sweep();
+    const sim::SimI2C::Stats& stats = topology.i2c.stats();
+    double busTime                  = static_cast<double>(stats.busTimeUs);
+
+    result->counter("i2c_transactions", stats.transactions);
+    result->counter("i2c_collisions", stats.collisions);
+    result->counter("i2c_nacks", stats.nacks);
+    result->counter("bad_readings", topology.badReadings());
+    result->counter("bus_time_us", busTime);
+    // Share of each main loop iteration the I2C bus is busy
+    result->counter("bus_load_pct", busTime / (busTime + MAIN_LOOP_WAIT_US) * 100.0);
+}
+
+} // namespace
+
+void runScalingBenchmarks(Suite& suite) {
+    static_assert(NUM_TEMP_SENSORS == 8 || NUM_TEMP_SENSORS == 16 || NUM_TEMP_SENSORS == 32,
+                  "There is no network of NUM_TEMP_SENSORS sensors to benchmark");
+
+    if constexpr (NUM_TEMP_SENSORS == 8) {
+        Topology topology;
+        topology.start({topology.addMux(topology.i2c.root(), 2)});
+        benchTopology(suite, "sweep.sensors.8", topology);
+    } else if constexpr (NUM_TEMP_SENSORS == 16) {
+        Topology topology;
+        topology.start({topology.addMux(topology.i2c.root(), 4)});
+        benchTopology(suite, "sweep.sensors.16", topology);
+    } else {
+        {
+            // Two muxes side by side on the main bus
+            Topology topology;
+            TMS::TCA954MUX* first  = topology.addMux(topology.i2c.root(), 4);
+            TMS::TCA954MUX* second = topology.addMux(topology.i2c.root(), 4);
+            topology.start({first, second});
+            benchTopology(suite, "sweep.sensors.32", topology);
+        }
+        {
+            // One mux on the main bus with two cascaded muxes behind it
+            Topology topology;
+            topology.start({topology.addMux(topology.i2c.root(), 4, 2, 3)});
+            benchTopology(suite, "sweep.sensors.32_cascaded", topology);
+        }
+    }
+}
+
+} // namespace bench
@@ -0,0 +1,121 @@
+/**
+ * Host benchmarks for the TMS acquisition and CAN paths. Results are printed as a table and optionally written as JSON
+ * and compared against a stored baseline, failing with a non-zero exit code on regressions. With --runs, the whole
+ * suite is repeated and the fastest time of each benchmark is kept. A baseline from another build type is refused.
+ *
+ * Built with TMS_BENCH_SCALING, the executable runs the scaling benchmarks for its NUM_TEMP_SENSORS instead, see
+ * tms-bench-sensors-* in CMakeLists.txt.
+ *
+ * Usage: tms-bench [--filter NAME] [--runs N] [--min-time-ms MS] [--output FILE] [--baseline FILE]
+ *                  [--time-threshold FRACTION] [--counter-threshold FRACTION]
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "Benchmark.hpp"
+#include "Benchmarks.hpp"
+
+namespace {
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program << " [--filter NAME] [--runs N] [--min-time-ms MS] [--output FILE]\n"
+              << "       [--baseline FILE] [--time-threshold FRACTION] [--counter-threshold FRACTION]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string filter;
+    std::string outputPath;
+    std::string baselinePath;
+    int runs                = 1;
+    double minTimeMs        = 20;
+    double timeThreshold    = 0.25;
+    double counterThreshold = 0.0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 2;
+        }
+
+        if (!std::strcmp(arg, "--filter")) {
+            filter = argv[++i];
+        } else if (!std::strcmp(arg, "--runs")) {
+            runs = std::atoi(argv[++i]);
+        } else if (!std::strcmp(arg, "--min-time-ms")) {
+            minTimeMs = std::atof(argv[++i]);
+        } else if (!std::strcmp(arg, "--output")) {
+            outputPath = argv[++i];
+        } else if (!std::strcmp(arg, "--baseline")) {
+            baselinePath = argv[++i];
+        } else if (!std::strcmp(arg, "--time-threshold")) {
+            timeThreshold = std::atof(argv[++i]);
+        } else if (!std::strcmp(arg, "--counter-threshold")) {
+            counterThreshold = std::atof(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    bench::Suite suite(minTimeMs, filter, TMS_BENCH_BUILD_TYPE);
+
+    // Read the baseline first, so a run that could not be compared is refused before it starts
+    bench::Json baseline;
+    if (!baselinePath.empty()) {
+        std::ifstream input(baselinePath);
+        if (!input) {
+            std::cerr << "Could not read " << baselinePath << "\n";
+            return 2;
+        }
+        std::stringstream text;
+        text << input.rdbuf();
+
+        std::string error;
+        if (!bench::Json::parse(text.str(), baseline, error)) {
+            std::cerr << baselinePath << ": " << error << "\n";
+            return 2;
+        }
+        if (!suite.comparable(baseline, std::cerr)) {
+            return 2;
+        }
+    }
+
+    for (int run = 0; run < runs; run++) {
+#ifdef TMS_BENCH_SCALING
+        bench::runScalingBenchmarks(suite);
+#else
+        bench::runAcquisitionBenchmarks(suite);
+        bench::runCANBenchmarks(suite);
+#endif
+    }
+    suite.print(std::cout);
+
+    if (!outputPath.empty()) {
+        std::ofstream output(outputPath);
+        if (!output) {
+            std::cerr << "Could not write " << outputPath << "\n";
+            return 2;
+        }
+        suite.writeJson(output);
+    }
+
+    if (baselinePath.empty()) {
+        return 0;
+    }
+
+    std::cout << "\nComparing against " << baselinePath << "\n";
+    int regressions = suite.compare(baseline, timeThreshold, counterThreshold, std::cout);
+    if (regressions) {
+        std::cout << regressions << " regression(s) beyond threshold\n";
+        return 1;
+    }
+    std::cout << "No regressions\n";
+    return 0;
+}
@@ -0,0 +1,83 @@
+#ifndef TMS_SIMBOARD_HPP
+#define TMS_SIMBOARD_HPP
+
+#include <TMS.hpp>
+#include <dev/TCA954MUX.hpp>
+#include <dev/TMP117.hpp>
+#include <sim/SimI2C.hpp>
+#include <sim/SimPWM.hpp>
+#include <sim/SimTCA954MUX.hpp>
+#include <sim/SimTMP117.hpp>
+
+namespace sim {
+
+/**
+ * The REV3-TMS board wired up against simulated peripherals. The sensor layout mirrors targets/REV3-TMS/main.cpp so
+ * host runs exercise the same topology as the firmware.
+ */
+class SimBoard {
+public:
+    /** Address of the TCA9545A on the board */
+    static constexpr uint8_t MUX_ADDRESS = 0x70;
+
+    /**
+     * Build the board. The simulated clock is not reset.
+     */
+    SimBoard();
+
+    SimBoard(const SimBoard&) = delete;
+
+    SimBoard& operator=(const SimBoard&) = delete;
+
+    /**
+     * Make every sensor due, so the next sweep reads all of them as it would without adaptive acquisition. TMS sets
+     * the poll period of each sensor again once it is read.
+     */
+    void pollEverySensor();
+
+    /** Simulated I2C bus the sensors and the mux are on */
+    SimI2C i2c;
+
+    /** Simulated TCA9545A */
+    SimTCA954MUX simMux;
+
+    /** Simulated TMP117s, indexed the same as sensorTemps */
+    SimTMP117 simSensors[NUM_TEMP_SENSORS];
+
+    /** Temperatures updated by the sensor drivers */
+    int16_t sensorTemps[NUM_TEMP_SENSORS] = {};
+
+    /** Firmware sensor drivers */
+    TMS::TMP117 sensors[NUM_TEMP_SENSORS];
+
+    /** Sensor drivers, as passed to TMS */
+    TMS::TMP117* sensorPointers[NUM_TEMP_SENSORS];
+
+    /** Simulated pump outputs */
+    SimPWM pumpPWM[2];
+
+    /** Driver pointers for each mux bus */
+    TMS::I2CDevice* bus0[2];
+    TMS::I2CDevice* bus1[2];
+    TMS::I2CDevice* bus2[1];
+    TMS::I2CDevice* bus3[1];
+    TMS::I2CDevice** buses[4];
+    uint8_t numDevices[4] = {2, 2, 1, 0};
+
+    /** Firmware mux driver */
+    TMS::TCA954MUX mux;
+
+    /** Muxes on the main bus, as passed to TMS */
+    TMS::TCA954MUX* muxes[1];
+    static_assert(sizeof(muxes) / sizeof(muxes[0]) <= TMS::TMS::MAX_MUXES, "TMS polls at most MAX_MUXES muxes");
+
+    /** Firmware pump drivers */
+    TMS::Pump pumps[2];
+
+    /** Board under test */
+    TMS::TMS tms;
+};
+
+} // namespace sim
+
+#endif // TMS_SIMBOARD_HPP
@@ -0,0 +1,40 @@
+#ifndef TMS_SIMCLOCK_HPP
+#define TMS_SIMCLOCK_HPP
+
+#include <cstdint>
+
+namespace sim {
+
+/**
+ * Virtual time base for host runs. EVT-core's time::millis() and time::wait() are backed by this clock, and simulated
+ * peripherals advance it by the time their transfers would take on the real bus.
+ */
+class SimClock {
+public:
+    /**
+     * Get the current simulated time
+     *
+     * @return Microseconds since the clock was last reset
+     */
+    static uint64_t micros();
+
+    /**
+     * Move the simulated time forward
+     *
+     * @param us Number of microseconds to advance by
+     */
+    static void advance(uint64_t us);
+
+    /**
+     * Reset the simulated time to 0
+     */
+    static void reset();
+
+private:
+    /** Current simulated time in microseconds */
+    static uint64_t now;
+};
+
+} // namespace sim
+
+#endif // TMS_SIMCLOCK_HPP
@@ -0,0 +1,201 @@
+#ifndef TMS_SIMI2C_HPP
+#define TMS_SIMI2C_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <core/io/I2C.hpp>
+
+namespace io = core::io;
+
+namespace sim {
+
+class SimI2CSegment;
+
+/**
+ * A simulated I2C target. Devices sit on a bus segment and are addressed through whatever switches are between them
+ * and the controller.
+ */
+class SimI2CDevice {
+public:
+    /**
+     * Construct a simulated device
+     *
+     * @param[in] address 7-bit I2C address the device responds to
+     */
+    explicit SimI2CDevice(uint8_t address);
+
+    virtual ~SimI2CDevice() = default;
+
+    /**
+     * Handle a write transfer addressed to this device
+     *
+     * @param[in] bytes Bytes written by the controller
+     * @param[in] length Number of bytes written
+     * @return Whether the device acknowledged the transfer
+     */
+    virtual bool onWrite(const uint8_t* bytes, uint8_t length) = 0;
+
+    /**
+     * Handle a read transfer addressed to this device
+     *
+     * @param[out] bytes Bytes returned to the controller
+     * @param[in] length Number of bytes requested
+     * @return Whether the device acknowledged the transfer
+     */
+    virtual bool onRead(uint8_t* bytes, uint8_t length) = 0;
+
+    /**
+     * Get the downstream segment connected through a channel of this device. Only bus switches have downstream
+     * segments.
+     *
+     * @param[in] channel Channel to look up
+     * @return The connected segment, or nullptr if the channel is not connected
+     */
+    virtual SimI2CSegment* downstream(uint8_t channel);
+
+    /** 7-bit I2C address the device responds to */
+    const uint8_t address;
+};
+
+/**
+ * A group of devices electrically connected to the same SCL/SDA pair
+ */
+class SimI2CSegment {
+public:
+    /**
+     * Attach a device to this segment
+     *
+     * @param[in] device Device to attach, must outlive the segment
+     */
+    void attach(SimI2CDevice& device);
+
+    /**
+     * Collect every device reachable with the given address, following enabled switch channels
+     *
+     * @param[in] address Address to look for
+     * @param[out] found Devices responding to the address
+     */
+    void resolve(uint8_t address, std::vector<SimI2CDevice*>& found);
+
+private:
+    /** Devices on this segment */
+    std::vector<SimI2CDevice*> devices;
+};
+
+/**
+ * Simulated I2C controller. Routes transfers to the simulated devices and models the time each transfer would take on
+ * the physical bus.
+ */
+class SimI2C : public io::I2C {
+public:
+    /**
+     * Bus activity accumulated since the last call to resetStats()
+     */
+    struct Stats {
+        /** Number of transfers started by the controller */
+        uint32_t transactions;
+        /** Number of payload bytes moved, excluding address bytes */
+        uint32_t bytes;
+        /** Number of transfers that were not acknowledged */
+        uint32_t nacks;
+        /** Number of transfers that more than one device acknowledged */
+        uint32_t collisions;
+        /** Modeled time spent on the bus */
+        uint64_t busTimeUs;
+    };
+
+    /**
+     * Construct a simulated I2C controller
+     *
+     * @param[in] scl Clock pin, only used to satisfy the EVT-core interface
+     * @param[in] sda Data pin, only used to satisfy the EVT-core interface
+     * @param[in] clockHz SCL frequency used to model transfer time
+     */
+    SimI2C(io::Pin scl, io::Pin sda, uint32_t clockHz = 100000);
+
+    /**
+     * Get the segment directly connected to the controller
+     *
+     * @return The root bus segment
+     */
+    SimI2CSegment& root();
+
+    /**
+     * Set whether transfers advance the simulated clock
+     *
+     * @param[in] advance True to advance SimClock by the modeled transfer time
+     */
+    void setAdvanceClock(bool advance);
+
+    /**
+     * Get the bus activity since the last reset
+     *
+     * @return Accumulated statistics
+     */
+    const Stats& stats() const;
+
+    /**
+     * Clear the accumulated statistics
+     */
+    void resetStats();
+
+    io::I2C::I2CStatus write(uint8_t addr, uint8_t byte) override;
+
+    io::I2C::I2CStatus read(uint8_t addr, uint8_t* output) override;
+
+    io::I2C::I2CStatus write(uint8_t addr, uint8_t* bytes, uint8_t length) override;
+
+    io::I2C::I2CStatus read(uint8_t addr, uint8_t* bytes, uint8_t length) override;
+
+    // The register helpers are modeled as a pointer write followed by a read, as a combined transfer on the wire
+    io::I2C::I2CStatus writeReg(uint8_t addr, uint8_t* reg, uint8_t regLength, uint8_t* bytes, uint8_t length);
+
+    io::I2C::I2CStatus readReg(uint8_t addr, uint8_t* reg, uint8_t regLength, uint8_t* bytes, uint8_t length);
+
+    io::I2C::I2CStatus writeMemReg(uint8_t addr, uint32_t memAddress, uint8_t byte, uint16_t memAddSize,
+                                   uint8_t maxWriteTime);
+
+    io::I2C::I2CStatus readMemReg(uint8_t addr, uint32_t memAddress, uint8_t* byte, uint16_t memAddSize);
+
+    io::I2C::I2CStatus writeMemReg(uint8_t addr, uint32_t memAddress, uint8_t* bytes, uint8_t size,
+                                   uint16_t memAddSize, uint8_t maxWriteTime);
+
+    io::I2C::I2CStatus readMemReg(uint8_t addr, uint32_t memAddress, uint8_t* bytes, uint8_t size,
+                                  uint16_t memAddSize);
+
+private:
+    /** Segment directly connected to the controller */
+    SimI2CSegment rootSegment;
+
+    /** SCL frequency */
+    uint32_t clockHz;
+
+    /** Whether transfers advance the simulated clock */
+    bool advanceClock = false;
+
+    /** Accumulated bus activity */
+    Stats busStats = {};
+
+    /** Scratch list used when resolving addresses */
+    std::vector<SimI2CDevice*> targets;
+
+    /**
+     * Account for one transfer on the bus
+     *
+     * @param[in] length Number of payload bytes in the transfer
+     */
+    void account(uint8_t length);
+
+    /**
+     * Find the single device that will respond to a transfer
+     *
+     * @param[in] addr Address of the transfer
+     * @return The target device, or nullptr on a NACK or collision
+     */
+    SimI2CDevice* target(uint8_t addr);
+};
+
+} // namespace sim
+
+#endif // TMS_SIMI2C_HPP
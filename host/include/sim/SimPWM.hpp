@@ -0,0 +1,40 @@
+#ifndef TMS_SIMPWM_HPP
+#define TMS_SIMPWM_HPP
+
+#include <core/io/PWM.hpp>
+
+namespace io = core::io;
+
+namespace sim {
+
+/**
+ * PWM output that records the last configured period and duty cycle
+ */
+class SimPWM : public io::PWM {
+public:
+    /**
+     * Construct a simulated PWM output
+     *
+     * @param[in] pin Output pin, only used to satisfy the EVT-core interface
+     */
+    explicit SimPWM(io::Pin pin);
+
+    void setDutyCycle(uint32_t dutyCycle) override;
+
+    void setPeriod(uint32_t period) override;
+
+    uint32_t getDutyCycle();
+
+    uint32_t getPeriod();
+
+private:
+    /** Last duty cycle set, in percent */
+    uint32_t dutyCycle = 0;
+
+    /** Last period set, in microseconds */
+    uint32_t period = 0;
+};
+
+} // namespace sim
+
+#endif // TMS_SIMPWM_HPP
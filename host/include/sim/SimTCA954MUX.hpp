@@ -0,0 +1,59 @@
+#ifndef TMS_SIMTCA954MUX_HPP
+#define TMS_SIMTCA954MUX_HPP
+
+#include <sim/SimI2C.hpp>
+
+namespace sim {
+
+/**
+ * Model of the TCA954x family of I2C switches. The single control register is a bit mask of the enabled channels.
+ * Datasheet: datasheets/tca9545a.pdf
+ */
+class SimTCA954MUX : public SimI2CDevice {
+public:
+    /** Largest channel count in the family (TCA9548A) */
+    static constexpr uint8_t MAX_CHANNELS = 8;
+
+    /**
+     * Construct a simulated switch
+     *
+     * @param[in] address 7-bit I2C address of the switch
+     * @param[in] numChannels Number of downstream channels, 4 for the TCA9545A
+     */
+    explicit SimTCA954MUX(uint8_t address = 0x70, uint8_t numChannels = 4);
+
+    /**
+     * Get the segment wired to a channel
+     *
+     * @param[in] channel Channel number
+     * @return The channel's segment
+     */
+    SimI2CSegment& channel(uint8_t channel);
+
+    /**
+     * Get the current value of the control register
+     *
+     * @return Mask of the enabled channels
+     */
+    uint8_t control() const;
+
+    bool onWrite(const uint8_t* bytes, uint8_t length) override;
+
+    bool onRead(uint8_t* bytes, uint8_t length) override;
+
+    SimI2CSegment* downstream(uint8_t channel) override;
+
+private:
+    /** Number of downstream channels */
+    uint8_t numChannels;
+
+    /** Control register, one bit per enabled channel */
+    uint8_t controlReg = 0;
+
+    /** Downstream segments */
+    SimI2CSegment channels[MAX_CHANNELS];
+};
+
+} // namespace sim
+
+#endif // TMS_SIMTCA954MUX_HPP
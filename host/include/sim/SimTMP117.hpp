@@ -0,0 +1,107 @@
+#ifndef TMS_SIMTMP117_HPP
+#define TMS_SIMTMP117_HPP
+
+#include <sim/SimI2C.hpp>
+
+namespace sim {
+
+/**
+ * Register-level model of the TMP117 temperature sensor, including the temperature offset and the EEPROM that loads
+ * the configuration and offset at power up
+ * Datasheet: datasheets/tmp117.pdf
+ */
+class SimTMP117 : public SimI2CDevice {
+public:
+    /**
+     * Construct a simulated TMP117
+     *
+     * @param[in] address 7-bit I2C address, selected by the ADD0 pin on the real part
+     * @param[in] celsius Initial temperature reported by the sensor
+     */
+    explicit SimTMP117(uint8_t address = 0x48, double celsius = 25.0);
+
+    /**
+     * Set the temperature the sensor measures. The result register also includes the temperature offset.
+     *
+     * @param[in] celsius Temperature in degrees celsius
+     */
+    void setTemperature(double celsius);
+
+    /**
+     * Get the raw value of a register
+     *
+     * @param[in] reg Register pointer
+     * @return The 16-bit register value
+     */
+    uint16_t reg(uint8_t reg) const;
+
+    /**
+     * Get the raw value stored in the EEPROM behind a register
+     *
+     * @param[in] reg Register pointer
+     * @return The 16-bit EEPROM value
+     */
+    uint16_t eeprom(uint8_t reg) const;
+
+    /**
+     * Reload the registers from EEPROM, as at power up
+     */
+    void powerCycle();
+
+    bool onWrite(const uint8_t* bytes, uint8_t length) override;
+
+    bool onRead(uint8_t* bytes, uint8_t length) override;
+
+    /** Register pointer values */
+    static constexpr uint8_t TEMP_RESULT   = 0x00;
+    static constexpr uint8_t CONFIGURATION = 0x01;
+    static constexpr uint8_t EEPROM_UL     = 0x04;
+    static constexpr uint8_t TEMP_OFFSET   = 0x07;
+    static constexpr uint8_t DEVICE_ID     = 0x0F;
+
+    /** Time the EEPROM is busy after a register write while unlocked */
+    static constexpr uint64_t EEPROM_PROGRAM_US = 7000;
+
+    /** Number of EEPROM programming cycles */
+    uint32_t eepromWrites = 0;
+
+private:
+    /** Number of addressable registers */
+    static constexpr uint8_t NUM_REGISTERS = 0x10;
+
+    /** EEPROM_UL bits */
+    static constexpr uint16_t EEPROM_UNLOCK = 0x8000;
+    static constexpr uint16_t EEPROM_BUSY   = 0x4000;
+
+    /** Register file */
+    uint16_t registers[NUM_REGISTERS] = {};
+
+    /** EEPROM behind the configuration, limit, offset and general purpose registers */
+    uint16_t eepromValues[NUM_REGISTERS] = {};
+
+    /** Measured temperature before the offset, in register LSBs */
+    int32_t measured = 0;
+
+    /** Register selected by the last write */
+    uint8_t pointer = TEMP_RESULT;
+
+    /** Simulated time EEPROM programming finishes */
+    uint64_t busyUntil = 0;
+
+    /**
+     * Whether a register is backed by EEPROM
+     *
+     * @param[in] reg Register pointer
+     * @return Whether writes program the EEPROM while it is unlocked
+     */
+    static bool hasEEPROM(uint8_t reg);
+
+    /**
+     * Recompute the result register from the measured temperature and the offset
+     */
+    void updateResult();
+};
+
+} // namespace sim
+
+#endif // TMS_SIMTMP117_HPP
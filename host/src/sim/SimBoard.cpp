@@ -0,0 +1,39 @@
+#include <sim/SimBoard.hpp>
+
+namespace sim {
+
+SimBoard::SimBoard()
+    : i2c(TMS::TMS::TEMP_SCL, TMS::TMS::TEMP_SDA), simMux(MUX_ADDRESS),
+      simSensors{SimTMP117(0x48, 30.0), SimTMP117(0x48, 31.0), SimTMP117(0x4A, 32.0), SimTMP117(0x48, 33.0),
+                 SimTMP117(0x4A, 34.0)},
+      // The drivers are complete before TMS is constructed, which sets their poll period
+      sensors{TMS::TMP117(&i2c, 0x48, &sensorTemps[0]), TMS::TMP117(&i2c, 0x48, &sensorTemps[1]),
+              TMS::TMP117(&i2c, 0x4A, &sensorTemps[2]), TMS::TMP117(&i2c, 0x48, &sensorTemps[3]),
+              TMS::TMP117(&i2c, 0x4A, &sensorTemps[4])},
+      sensorPointers{&sensors[0], &sensors[1], &sensors[2], &sensors[3], &sensors[4]},
+      pumpPWM{SimPWM(TMS::TMS::PUMP1_PWM), SimPWM(TMS::TMS::PUMP2_PWM)}, bus0{&sensors[1], &sensors[2]},
+      bus1{&sensors[3], &sensors[4]}, bus2{&sensors[0]}, bus3{}, buses{bus0, bus1, bus2, bus3},
+      mux(i2c, MUX_ADDRESS, buses, numDevices), muxes{&mux}, pumps{TMS::Pump(pumpPWM[0]), TMS::Pump(pumpPWM[1])},
+      tms(sensorTemps, sensorPointers, muxes, 1, pumps) {
+
+    i2c.root().attach(simMux);
+
+    // Bus 2 on-board sensor
+    simMux.channel(2).attach(simSensors[0]);
+
+    // Bus 0 devices
+    simMux.channel(0).attach(simSensors[1]);
+    simMux.channel(0).attach(simSensors[2]);
+
+    // Bus 1 devices
+    simMux.channel(1).attach(simSensors[3]);
+    simMux.channel(1).attach(simSensors[4]);
+}
+
+void SimBoard::pollEverySensor() {
+    for (TMS::TMP117& sensor : sensors) {
+        sensor.setPollPeriod(0);
+    }
+}
+
+} // namespace sim
@@ -0,0 +1,19 @@
+#include <sim/SimClock.hpp>
+
+namespace sim {
+
+uint64_t SimClock::now = 0;
+
+uint64_t SimClock::micros() {
+    return now;
+}
+
+void SimClock::advance(uint64_t us) {
+    now += us;
+}
+
+void SimClock::reset() {
+    now = 0;
+}
+
+} // namespace sim
@@ -0,0 +1,157 @@
+#include <sim/SimClock.hpp>
+#include <sim/SimI2C.hpp>
+
+namespace sim {
+
+SimI2CDevice::SimI2CDevice(uint8_t address) : address(address) {}
+
+SimI2CSegment* SimI2CDevice::downstream(uint8_t) {
+    return nullptr;
+}
+
+void SimI2CSegment::attach(SimI2CDevice& device) {
+    devices.push_back(&device);
+}
+
+void SimI2CSegment::resolve(uint8_t address, std::vector<SimI2CDevice*>& found) {
+    for (SimI2CDevice* device : devices) {
+        if (device->address == address) {
+            found.push_back(device);
+        }
+
+        // Switches only pass traffic through to the channels that are currently enabled
+        for (uint8_t channel = 0; channel < 8; channel++) {
+            SimI2CSegment* segment = device->downstream(channel);
+            if (segment) {
+                segment->resolve(address, found);
+            }
+        }
+    }
+}
+
+SimI2C::SimI2C(io::Pin scl, io::Pin sda, uint32_t clockHz) : io::I2C(scl, sda), clockHz(clockHz) {}
+
+SimI2CSegment& SimI2C::root() {
+    return rootSegment;
+}
+
+void SimI2C::setAdvanceClock(bool advance) {
+    advanceClock = advance;
+}
+
+const SimI2C::Stats& SimI2C::stats() const {
+    return busStats;
+}
+
+void SimI2C::resetStats() {
+    busStats = {};
+}
+
+void SimI2C::account(uint8_t length) {
+    // START + address/RW + ACK, 9 clocks per data byte, STOP
+    uint32_t bits = 1 + 9 + 9 * static_cast<uint32_t>(length) + 1;
+    uint64_t us   = (static_cast<uint64_t>(bits) * 1000000 + clockHz - 1) / clockHz;
+
+    busStats.transactions++;
+    busStats.bytes += length;
+    busStats.busTimeUs += us;
+
+    if (advanceClock) {
+        SimClock::advance(us);
+    }
+}
+
+SimI2CDevice* SimI2C::target(uint8_t addr) {
+    targets.clear();
+    rootSegment.resolve(addr, targets);
+
+    if (targets.empty()) {
+        busStats.nacks++;
+        return nullptr;
+    }
+    if (targets.size() > 1) {
+        busStats.collisions++;
+        return nullptr;
+    }
+    return targets[0];
+}
+
+io::I2C::I2CStatus SimI2C::write(uint8_t addr, uint8_t byte) {
+    return write(addr, &byte, 1);
+}
+
+io::I2C::I2CStatus SimI2C::read(uint8_t addr, uint8_t* output) {
+    return read(addr, output, 1);
+}
+
+io::I2C::I2CStatus SimI2C::write(uint8_t addr, uint8_t* bytes, uint8_t length) {
+    account(length);
+
+    SimI2CDevice* device = target(addr);
+    if (!device || !device->onWrite(bytes, length)) {
+        return io::I2C::I2CStatus::ERROR;
+    }
+    return io::I2C::I2CStatus::OK;
+}
+
+io::I2C::I2CStatus SimI2C::read(uint8_t addr, uint8_t* bytes, uint8_t length) {
+    account(length);
+
+    SimI2CDevice* device = target(addr);
+    if (!device || !device->onRead(bytes, length)) {
+        return io::I2C::I2CStatus::ERROR;
+    }
+    return io::I2C::I2CStatus::OK;
+}
+
+io::I2C::I2CStatus SimI2C::writeReg(uint8_t addr, uint8_t* reg, uint8_t regLength, uint8_t* bytes, uint8_t length) {
+    uint8_t buffer[UINT8_MAX];
+    uint8_t total = 0;
+
+    for (uint8_t i = 0; i < regLength; i++) {
+        buffer[total++] = reg[i];
+    }
+    for (uint8_t i = 0; i < length && total < UINT8_MAX; i++) {
+        buffer[total++] = bytes[i];
+    }
+
+    return write(addr, buffer, total);
+}
+
+io::I2C::I2CStatus SimI2C::readReg(uint8_t addr, uint8_t* reg, uint8_t regLength, uint8_t* bytes, uint8_t length) {
+    io::I2C::I2CStatus status = write(addr, reg, regLength);
+    if (status != io::I2C::I2CStatus::OK) {
+        return status;
+    }
+    return read(addr, bytes, length);
+}
+
+io::I2C::I2CStatus SimI2C::writeMemReg(uint8_t addr, uint32_t memAddress, uint8_t byte, uint16_t memAddSize,
+                                       uint8_t maxWriteTime) {
+    return writeMemReg(addr, memAddress, &byte, 1, memAddSize, maxWriteTime);
+}
+
+io::I2C::I2CStatus SimI2C::readMemReg(uint8_t addr, uint32_t memAddress, uint8_t* byte, uint16_t memAddSize) {
+    return readMemReg(addr, memAddress, byte, 1, memAddSize);
+}
+
+io::I2C::I2CStatus SimI2C::writeMemReg(uint8_t addr, uint32_t memAddress, uint8_t* bytes, uint8_t size,
+                                       uint16_t memAddSize, uint8_t) {
+    // Simulated devices finish writes within the transfer, so there is no write time to wait out
+    uint8_t reg[4];
+    for (uint16_t i = 0; i < memAddSize && i < 4; i++) {
+        reg[i] = static_cast<uint8_t>(memAddress >> (8 * (memAddSize - 1 - i)));
+    }
+    return writeReg(addr, reg, static_cast<uint8_t>(memAddSize), bytes, size);
+}
+
+io::I2C::I2CStatus SimI2C::readMemReg(uint8_t addr, uint32_t memAddress, uint8_t* bytes, uint8_t size,
+                                      uint16_t memAddSize) {
+    uint8_t reg[4];
+    for (uint16_t i = 0; i < memAddSize && i < 4; i++) {
+        reg[i] = static_cast<uint8_t>(memAddress >> (8 * (memAddSize - 1 - i)));
+    }
+    return readReg(addr, reg, static_cast<uint8_t>(memAddSize), bytes, size);
+}
+
+} // namespace sim
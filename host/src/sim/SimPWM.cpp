@@ -0,0 +1,23 @@
+#include <sim/SimPWM.hpp>
+
+namespace sim {
+
+SimPWM::SimPWM(io::Pin pin) : io::PWM(pin) {}
+
+void SimPWM::setDutyCycle(uint32_t dutyCycle) {
+    this->dutyCycle = dutyCycle;
+}
+
+void SimPWM::setPeriod(uint32_t period) {
+    this->period = period;
+}
+
+uint32_t SimPWM::getDutyCycle() {
+    return dutyCycle;
+}
+
+uint32_t SimPWM::getPeriod() {
+    return period;
+}
+
+} // namespace sim
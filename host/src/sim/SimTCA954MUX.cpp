@@ -0,0 +1,40 @@
+#include <sim/SimTCA954MUX.hpp>
+
+namespace sim {
+
+SimTCA954MUX::SimTCA954MUX(uint8_t address, uint8_t numChannels)
+    : SimI2CDevice(address), numChannels(numChannels < MAX_CHANNELS ? numChannels : MAX_CHANNELS) {}
+
+SimI2CSegment& SimTCA954MUX::channel(uint8_t channel) {
+    return channels[channel % MAX_CHANNELS];
+}
+
+uint8_t SimTCA954MUX::control() const {
+    return controlReg;
+}
+
+bool SimTCA954MUX::onWrite(const uint8_t* bytes, uint8_t length) {
+    if (length == 0) {
+        return false;
+    }
+
+    // Bits for channels the part does not have are ignored
+    controlReg = bytes[length - 1] & static_cast<uint8_t>((1u << numChannels) - 1);
+    return true;
+}
+
+bool SimTCA954MUX::onRead(uint8_t* bytes, uint8_t length) {
+    for (uint8_t i = 0; i < length; i++) {
+        bytes[i] = controlReg;
+    }
+    return true;
+}
+
+SimI2CSegment* SimTCA954MUX::downstream(uint8_t channel) {
+    if (channel >= numChannels || !(controlReg & (1u << channel))) {
+        return nullptr;
+    }
+    return &channels[channel];
+}
+
+} // namespace sim
@@ -0,0 +1,100 @@
+#include <cmath>
+
+#include <sim/SimClock.hpp>
+#include <sim/SimTMP117.hpp>
+
+namespace sim {
+
+SimTMP117::SimTMP117(uint8_t address, double celsius) : SimI2CDevice(address) {
+    // Factory EEPROM contents, loaded into the registers at power up
+    eepromValues[CONFIGURATION] = 0x0220;
+    eepromValues[0x02]          = 0x6000; // THigh limit
+    eepromValues[0x03]          = 0x8000; // TLow limit
+    registers[DEVICE_ID]        = 0x0117;
+    powerCycle();
+    setTemperature(celsius);
+}
+
+void SimTMP117::setTemperature(double celsius) {
+    // 1 LSB = 7.8125 m°C
+    measured = static_cast<int32_t>(std::lround(celsius / 0.0078125));
+    updateResult();
+}
+
+void SimTMP117::updateResult() {
+    int32_t raw = measured + static_cast<int16_t>(registers[TEMP_OFFSET]);
+    if (raw > INT16_MAX) {
+        raw = INT16_MAX;
+    } else if (raw < INT16_MIN) {
+        raw = INT16_MIN;
+    }
+    registers[TEMP_RESULT] = static_cast<uint16_t>(static_cast<int16_t>(raw));
+}
+
+uint16_t SimTMP117::reg(uint8_t reg) const {
+    return reg < NUM_REGISTERS ? registers[reg] : 0;
+}
+
+uint16_t SimTMP117::eeprom(uint8_t reg) const {
+    return reg < NUM_REGISTERS ? eepromValues[reg] : 0;
+}
+
+void SimTMP117::powerCycle() {
+    for (uint8_t reg = 0; reg < NUM_REGISTERS; reg++) {
+        if (hasEEPROM(reg)) {
+            registers[reg] = eepromValues[reg];
+        }
+    }
+    registers[EEPROM_UL] = 0;
+    busyUntil            = 0;
+    updateResult();
+}
+
+bool SimTMP117::hasEEPROM(uint8_t reg) {
+    return (reg >= CONFIGURATION && reg <= 0x03) || (reg >= 0x05 && reg <= 0x08);
+}
+
+bool SimTMP117::onWrite(const uint8_t* bytes, uint8_t length) {
+    if (length == 0 || bytes[0] >= NUM_REGISTERS) {
+        return false;
+    }
+    pointer = bytes[0];
+
+    // Pointer followed by a big-endian register value
+    if (length >= 3 && pointer != TEMP_RESULT && pointer != DEVICE_ID) {
+        uint16_t value = static_cast<uint16_t>(bytes[1] << 8 | bytes[2]);
+
+        if (pointer == EEPROM_UL) {
+            registers[EEPROM_UL] = value & EEPROM_UNLOCK;
+            return true;
+        }
+
+        // The part does not acknowledge writes while the EEPROM is being programmed
+        if (SimClock::micros() < busyUntil) {
+            return false;
+        }
+        registers[pointer] = value;
+        if ((registers[EEPROM_UL] & EEPROM_UNLOCK) && hasEEPROM(pointer)) {
+            eepromValues[pointer] = value;
+            busyUntil             = SimClock::micros() + EEPROM_PROGRAM_US;
+            eepromWrites++;
+        }
+        if (pointer == TEMP_OFFSET) {
+            updateResult();
+        }
+    }
+    return true;
+}
+
+bool SimTMP117::onRead(uint8_t* bytes, uint8_t length) {
+    uint16_t value = registers[pointer];
+    if (pointer == EEPROM_UL && SimClock::micros() < busyUntil) {
+        value |= EEPROM_BUSY;
+    }
+    for (uint8_t i = 0; i < length; i++) {
+        bytes[i] = i % 2 == 0 ? static_cast<uint8_t>(value >> 8) : static_cast<uint8_t>(value);
+    }
+    return true;
+}
+
+} // namespace sim
@@ -0,0 +1,19 @@
+/**
+ * Host implementation of the EVT-core time utilities. Time is driven by the simulated clock so that host runs are
+ * deterministic and do not actually sleep.
+ */
+
+#include <core/utils/time.hpp>
+#include <sim/SimClock.hpp>
+
+namespace core::time {
+
+void wait(uint32_t ms) {
+    sim::SimClock::advance(static_cast<uint64_t>(ms) * 1000);
+}
+
+uint32_t millis() {
+    return static_cast<uint32_t>(sim::SimClock::micros() / 1000);
+}
+
+} // namespace core::time
@@ -0,0 +1,56 @@
+#ifndef TMS_OBJECTDICTIONARY_HPP
+#define TMS_OBJECTDICTIONARY_HPP
+
+#include <cstdint>
+
+#include <co_core.h>
+
+namespace TMS {
+
+/**
+ * Result of validating an object dictionary
+ */
+enum class ODStatus {
+    OK,
+    /** An entry is out of order, which breaks the CANopen stack's bisecting lookup */
+    UNSORTED,
+    /** Two entries share the same index and sub-index */
+    DUPLICATE,
+    /** An entry before the declared size is an end marker, or the entry at the declared size is not */
+    SIZE_MISMATCH,
+};
+
+/**
+ * Validate a dictionary the way the CANopen stack needs it. The stack bisects the dictionary in CODictFind() and
+ * silently fails lookups on an unsorted dictionary or one whose declared size does not match its contents.
+ *
+ * @param[in] dictionary Dictionary to validate
+ * @param[in] numElements Number of entries before the end marker
+ * @return Result of validation
+ */
+inline ODStatus validateDictionary(const CO_OBJ_T* dictionary, uint16_t numElements) {
+    for (uint16_t i = 0; i < numElements; i++) {
+        if (dictionary[i].Key == 0) {
+            return ODStatus::SIZE_MISMATCH;
+        }
+        if (i > 0) {
+            uint32_t key      = CO_GET_DEV(dictionary[i].Key);
+            uint32_t previous = CO_GET_DEV(dictionary[i - 1].Key);
+            if (key == previous) {
+                return ODStatus::DUPLICATE;
+            }
+            if (key < previous) {
+                return ODStatus::UNSORTED;
+            }
+        }
+    }
+
+    if (dictionary[numElements].Key != 0) {
+        return ODStatus::SIZE_MISMATCH;
+    }
+    return ODStatus::OK;
+}
+
+} // namespace TMS
+
+#endif // TMS_OBJECTDICTIONARY_HPP
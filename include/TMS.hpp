@@ -5,11 +5,16 @@
 #include <core/dev/Thermistor.hpp>
 #include <core/io/CANDevice.hpp>
 #include <core/io/CANOpenMacros.hpp>
+#include <core/io/CANopen.hpp>
 #include <core/io/GPIO.hpp>
 #include <core/io/pin.hpp>
 #include <core/utils/log.hpp>
+#include <ObjectDictionary.hpp>
+#include <TripleBuffer.hpp>
+#include <can/TMSMessages.hpp>
 #include <dev/Pump.hpp>
 #include <dev/TCA954MUX.hpp>
+#include <dev/TMP117.hpp>
 
 #ifndef NUM_TEMP_SENSORS
     #define NUM_TEMP_SENSORS 5
@@ -45,6 +50,51 @@
         .Type = CO_TUNSIGNED32,                                                       \
         .Data = (CO_DATA) CO_LINK(0x2200 + RPDO_NUMBER, 0x00 + SUB_INDEX, DATA_SIZE), \
     }
+//TPDO mapping entry linking to a variable instead of a fixed object, so the mapping can be changed over SDO
+#define TRANSMIT_PDO_MAPPING_ENTRY_RW_1AXX(TPDO_NUMBER, SUB_INDEX, MAPPING_POINTER) \
+    {                                                                             \
+        .Key  = CO_KEY(0x1A00 + TPDO_NUMBER, SUB_INDEX, CO_OBJ_____RW),           \
+        .Type = CO_TUNSIGNED32,                                                   \
+        .Data = (CO_DATA) MAPPING_POINTER,                                        \
+    }
+//Data link entry for one sensor, expanded for every sensor by TMS_REPEAT
+#define SENSOR_DATA_LINK_21XX(SUB_INDEX, DATA_LINK_NUMBER, DATA_TYPE, ARRAY) \
+    DATA_LINK_21XX(DATA_LINK_NUMBER, SUB_INDEX, DATA_TYPE, &ARRAY[SUB_INDEX - 1]),
+//Expands M(SUB_INDEX, ...) for SUB_INDEX 1 to N, N must be a plain number up to 32
+#define TMS_REPEAT(N, M, ...) TMS_REPEAT_N(N, M, __VA_ARGS__)
+#define TMS_REPEAT_N(N, M, ...) TMS_REPEAT_##N(M, __VA_ARGS__)
+#define TMS_REPEAT_1(M, ...) M(1, __VA_ARGS__)
+#define TMS_REPEAT_2(M, ...) TMS_REPEAT_1(M, __VA_ARGS__) M(2, __VA_ARGS__)
+#define TMS_REPEAT_3(M, ...) TMS_REPEAT_2(M, __VA_ARGS__) M(3, __VA_ARGS__)
+#define TMS_REPEAT_4(M, ...) TMS_REPEAT_3(M, __VA_ARGS__) M(4, __VA_ARGS__)
+#define TMS_REPEAT_5(M, ...) TMS_REPEAT_4(M, __VA_ARGS__) M(5, __VA_ARGS__)
+#define TMS_REPEAT_6(M, ...) TMS_REPEAT_5(M, __VA_ARGS__) M(6, __VA_ARGS__)
+#define TMS_REPEAT_7(M, ...) TMS_REPEAT_6(M, __VA_ARGS__) M(7, __VA_ARGS__)
+#define TMS_REPEAT_8(M, ...) TMS_REPEAT_7(M, __VA_ARGS__) M(8, __VA_ARGS__)
+#define TMS_REPEAT_9(M, ...) TMS_REPEAT_8(M, __VA_ARGS__) M(9, __VA_ARGS__)
+#define TMS_REPEAT_10(M, ...) TMS_REPEAT_9(M, __VA_ARGS__) M(10, __VA_ARGS__)
+#define TMS_REPEAT_11(M, ...) TMS_REPEAT_10(M, __VA_ARGS__) M(11, __VA_ARGS__)
+#define TMS_REPEAT_12(M, ...) TMS_REPEAT_11(M, __VA_ARGS__) M(12, __VA_ARGS__)
+#define TMS_REPEAT_13(M, ...) TMS_REPEAT_12(M, __VA_ARGS__) M(13, __VA_ARGS__)
+#define TMS_REPEAT_14(M, ...) TMS_REPEAT_13(M, __VA_ARGS__) M(14, __VA_ARGS__)
+#define TMS_REPEAT_15(M, ...) TMS_REPEAT_14(M, __VA_ARGS__) M(15, __VA_ARGS__)
+#define TMS_REPEAT_16(M, ...) TMS_REPEAT_15(M, __VA_ARGS__) M(16, __VA_ARGS__)
+#define TMS_REPEAT_17(M, ...) TMS_REPEAT_16(M, __VA_ARGS__) M(17, __VA_ARGS__)
+#define TMS_REPEAT_18(M, ...) TMS_REPEAT_17(M, __VA_ARGS__) M(18, __VA_ARGS__)
+#define TMS_REPEAT_19(M, ...) TMS_REPEAT_18(M, __VA_ARGS__) M(19, __VA_ARGS__)
+#define TMS_REPEAT_20(M, ...) TMS_REPEAT_19(M, __VA_ARGS__) M(20, __VA_ARGS__)
+#define TMS_REPEAT_21(M, ...) TMS_REPEAT_20(M, __VA_ARGS__) M(21, __VA_ARGS__)
+#define TMS_REPEAT_22(M, ...) TMS_REPEAT_21(M, __VA_ARGS__) M(22, __VA_ARGS__)
+#define TMS_REPEAT_23(M, ...) TMS_REPEAT_22(M, __VA_ARGS__) M(23, __VA_ARGS__)
+#define TMS_REPEAT_24(M, ...) TMS_REPEAT_23(M, __VA_ARGS__) M(24, __VA_ARGS__)
+#define TMS_REPEAT_25(M, ...) TMS_REPEAT_24(M, __VA_ARGS__) M(25, __VA_ARGS__)
+#define TMS_REPEAT_26(M, ...) TMS_REPEAT_25(M, __VA_ARGS__) M(26, __VA_ARGS__)
+#define TMS_REPEAT_27(M, ...) TMS_REPEAT_26(M, __VA_ARGS__) M(27, __VA_ARGS__)
+#define TMS_REPEAT_28(M, ...) TMS_REPEAT_27(M, __VA_ARGS__) M(28, __VA_ARGS__)
+#define TMS_REPEAT_29(M, ...) TMS_REPEAT_28(M, __VA_ARGS__) M(29, __VA_ARGS__)
+#define TMS_REPEAT_30(M, ...) TMS_REPEAT_29(M, __VA_ARGS__) M(30, __VA_ARGS__)
+#define TMS_REPEAT_31(M, ...) TMS_REPEAT_30(M, __VA_ARGS__) M(31, __VA_ARGS__)
+#define TMS_REPEAT_32(M, ...) TMS_REPEAT_31(M, __VA_ARGS__) M(32, __VA_ARGS__)
 // clang-format on
 
 namespace dev = core::dev;
@@ -53,6 +103,28 @@ namespace io  = core::io;
 
 namespace TMS {
 
+/**
+ * Check that a message generated from the DBC has the layout the CANopen stack packs a TPDO with, given its mapping
+ * of 16 bit objects: one little-endian signal per mapped object, in mapping order.
+ *
+ * @tparam Message Generated message from can/TMSMessages.hpp
+ * @param[in] numObjects Number of objects in the TPDO mapping
+ * @return Whether the layouts match
+ */
+template<typename Message>
+constexpr bool matchesPDOMapping16(uint8_t numObjects) {
+    if (Message::EXTENDED || Message::NUM_SIGNALS != numObjects || Message::LENGTH != numObjects * 2) {
+        return false;
+    }
+    for (uint8_t i = 0; i < Message::NUM_SIGNALS; i++) {
+        const can::Signal& signal = Message::SIGNALS[i];
+        if (signal.start != i * 16 || signal.length != 16 || !signal.littleEndian) {
+            return false;
+        }
+    }
+    return true;
+}
+
 /**
  * Main board class for the Temperature Management System (TMS). Holds the object dictionary, handles updating the
  * temperature sensor values, and controlling the pumps.
@@ -71,17 +143,69 @@ public:
     static constexpr io::Pin FLOW1_PWM = io::Pin::PB_15;
     static constexpr io::Pin FLOW2_PWM = io::Pin::PB_14;
 
+    /** Number of temperature slots across the temperature TPDOs */
+    static constexpr uint8_t NUM_TEMP_PDO_SLOTS = 8;
+
+    /** Temperature transmitted in a TPDO slot mapped to the empty object at 0x2102 */
+    static constexpr int16_t PDO_SLOT_EMPTY_TEMP = INT16_MIN;
+
+    /** Largest sensor count the per-sensor object dictionary entries can be expanded for */
+    static constexpr uint8_t MAX_TEMP_SENSORS = 32;
+
+    static_assert(NUM_TEMP_SENSORS <= MAX_TEMP_SENSORS, "TMS_REPEAT only expands up to 32 sensors");
+
+    /** Maximum number of TCA954x instances polled on the main I2C bus */
+    static constexpr uint8_t MAX_MUXES = 4;
+
+    /**
+     * Calibration commands, written to 0x2400 sub 1 over SDO and run by process()
+     */
+    enum class CalibrationCommand : uint8_t {
+        /** No command, the value the command reads back once it has been accepted */
+        NONE = 0,
+        /** Write the offsets at 0x2401 to the sensors */
+        APPLY = 1,
+        /** Write the offsets at 0x2401 to the sensors and program them into their EEPROM */
+        APPLY_PERSIST = 2,
+        /** Measure every sensor against the reference sensor, then write the offsets that make them agree */
+        CALIBRATE = 3,
+        /** CALIBRATE, also programming the offsets into EEPROM */
+        CALIBRATE_PERSIST = 4,
+        /** Read the offsets and configuration back from the sensors */
+        VERIFY = 5,
+    };
+
+    /**
+     * Progress of the last calibration command, at 0x2400 sub 4
+     */
+    enum class CalibrationState : uint8_t {
+        /** No command has been run since boot */
+        IDLE = 0,
+        /** Averaging the readings against the reference sensor */
+        MEASURING = 1,
+        /** Waiting for the sensors to be written or read back */
+        APPLYING = 2,
+        /** Every sensor finished, see 0x2402 for each sensor */
+        DONE = 3,
+        /** The command was invalid, a sensor failed or had no valid readings, or a sensor did not respond in time */
+        FAILED = 4,
+    };
+
     /**
      * Construct a TMS instance
      *
      * @param sensorTemps An array of sensor temperatures updated by each temperature sensor instance
-     * @param tca954mux I2C MUX instance to use for getting temp sensor data
+     * @param sensors The sensor driver updating each entry of sensorTemps, used for calibration and to schedule reads
+     * @param muxes I2C MUX instances on the main I2C bus to use for getting temp sensor data. Cascaded muxes are
+     * polled through the mux they are attached to and are not listed here.
+     * @param numMuxes Number of MUX instances in muxes, muxes past MAX_MUXES are not polled
      * @param pumps The pumps to control
      */
-    TMS(int16_t* sensorTemps, TCA954MUX& tca954mux, Pump pumps[2]);
+    TMS(int16_t* sensorTemps, TMP117* sensors[], TCA954MUX* muxes[], uint8_t numMuxes, Pump pumps[2]);
 
     /**
-     * Pointer to the array to store the thermistor values.
+     * Pointer to the array the sensor drivers store their readings in. It is written sensor by sensor during a sweep,
+     * so it is only read by process() once the sweep is done, the TPDOs read the published sweeps.
      */
     int16_t* sensorTemps;
 
@@ -96,6 +220,13 @@ public:
      */
     void process();
 
+    /**
+     * Refresh the objects the temperature TPDOs map, and 0x2600, from the latest published sweep. Call it where the
+     * CANopen stack reads those objects, right before processCANopenNode(), so every TPDO carries the readings of a
+     * single sweep.
+     */
+    void updatePDOTemps();
+
     /**
      * Set current NMT mode
      *
@@ -103,6 +234,16 @@ public:
      */
     void setMode(CO_MODE newMode);
 
+    /**
+     * Interrupt handler to get CAN messages. A function pointer to this function
+     * will be passed to the EVT-core CAN interface which will in turn call this
+     * function each time a new CAN message comes in.
+     *
+     * @param message[in] The passed in CAN message that was read.
+     * @param priv[in] The private data (FixedQueue<CANOPEN_QUEUE_SIZE, CANMessage>)
+     */
+    static void canInterrupt(io::CANMessage& message, void* priv);
+
 private:
     /** The node ID used to identify the device on the CAN network */
     static constexpr uint8_t NODE_ID = 0x02;
@@ -112,8 +253,10 @@ private:
     /** Current NMT Mode */
     CO_MODE mode = CO_PREOP;
 
-    /** TCA9545A instance */
-    TCA954MUX& tca954mux;
+    /** TCA954x instances on the main I2C bus */
+    TCA954MUX* muxes[MAX_MUXES];
+    /** Number of TCA954x instances on the main I2C bus */
+    uint8_t numMuxes;
     /** Heat pump instance */
     Pump pumps[2];
 
@@ -122,11 +265,157 @@ private:
     /** Water flow rate */
     uint16_t flowRate[2] = {0, 0};
 
+    /** Object each temperature TPDO slot carries, as the CO_LINK of its 0x1A01/0x1A02 entry, configurable over SDO */
+    uint32_t pdoMappings[NUM_TEMP_PDO_SLOTS];
+    /**
+     * Temperature of each sensor from the published sweep, the objects the temperature TPDOs map. Only written by
+     * updatePDOTemps(), along with pdoSequence and pdoSweepMs.
+     */
+    int16_t publishedTemps[NUM_TEMP_SENSORS];
+    /** Value of the empty object, mapped by TPDO slots that carry no sensor */
+    int16_t emptySlotTemp = PDO_SLOT_EMPTY_TEMP;
+    /** Sequence number of the sweep the TPDO temperatures come from */
+    uint32_t pdoSequence = 0;
+    /** time::millis() at the latest read of the sweep the TPDO temperatures come from */
+    uint32_t pdoSweepMs = 0;
+
+    /**
+     * Readings of every sensor from one sweep
+     */
+    struct Sweep {
+        /** time::millis() at the latest read of the sweep */
+        uint32_t timeMs;
+        /** Temperature of each sensor, indexed the same as sensorTemps */
+        int16_t temps[NUM_TEMP_SENSORS];
+    };
+
+    /** Sweeps published by process(), read by updatePDOTemps() */
+    TripleBuffer<Sweep> sweeps;
+
+    /**
+     * Copy the readings of the last sweep into a new publication
+     *
+     * @param readMs time::millis() at the latest read of the sweep
+     */
+    void publishSweep(uint32_t readMs);
+
+    /** Default shortest time between reads of a sensor */
+    static constexpr uint16_t DEFAULT_MIN_POLL_PERIOD_MS = 100;
+
+    /** Default longest time between reads of a sensor */
+    static constexpr uint16_t DEFAULT_MAX_POLL_PERIOD_MS = 1000;
+
+    /** Default change in centi-celsius a sensor is allowed between reads */
+    static constexpr uint16_t DEFAULT_POLL_STEP = 10;
+
+    /** Weight of the rate estimates, each new rate moves the estimate by 1/RATE_SMOOTHING of the difference */
+    static constexpr int32_t RATE_SMOOTHING = 4;
+
+    /** Shortest time between reads of a sensor in milliseconds, configurable over SDO */
+    uint16_t minPollPeriod = DEFAULT_MIN_POLL_PERIOD_MS;
+    /** Longest time between reads of a sensor in milliseconds, configurable over SDO */
+    uint16_t maxPollPeriod = DEFAULT_MAX_POLL_PERIOD_MS;
+    /** Change in centi-celsius a sensor is allowed between reads, configurable over SDO */
+    uint16_t pollStep = DEFAULT_POLL_STEP;
+    /** Measured time between the last two reads of each sensor in milliseconds */
+    uint16_t pollPeriods[NUM_TEMP_SENSORS] = {};
+    /** Smoothed rate of change of each sensor in centi-celsius per second */
+    int16_t temperatureRates[NUM_TEMP_SENSORS] = {};
+
+    /** Read count of each sensor when its rate was last updated */
+    uint16_t acquisitionReads[NUM_TEMP_SENSORS] = {};
+    /** Time of the last read of each sensor */
+    uint32_t acquisitionLastMs[NUM_TEMP_SENSORS] = {};
+    /** Temperature at the last read of each sensor */
+    int16_t acquisitionLastTemps[NUM_TEMP_SENSORS];
+
+    /**
+     * Update the rate of change of each sensor read by the last sweep and set its next poll period
+     *
+     * @param[out] readMs time::millis() at the latest read of the sweep, only set if a sensor was read
+     * @return Whether the sweep read any sensor
+     */
+    bool processAcquisition(uint32_t& readMs);
+
+    /**
+     * Get the poll period for a rate of change, such that the temperature moves about pollStep between reads
+     *
+     * @param rate Rate of change in centi-celsius per second
+     * @return Time between reads in milliseconds, between minPollPeriod and maxPollPeriod
+     */
+    uint16_t pollPeriodForRate(int16_t rate) const;
+
+    /** Time between calibration samples, one conversion cycle of the sensors */
+    static constexpr uint32_t CALIBRATION_SAMPLE_PERIOD_MS = 1000;
+
+    /** Default number of samples averaged by a calibration */
+    static constexpr uint8_t DEFAULT_CALIBRATION_SAMPLES = 8;
+
+    /** Time the sensors are given to finish a calibration write or read back */
+    static constexpr uint32_t CALIBRATION_APPLY_TIMEOUT_MS = 1000;
+
+    /** Sensor drivers, indexed the same as sensorTemps */
+    TMP117* sensors[NUM_TEMP_SENSORS];
+
+    /** Calibration command written over SDO, a CalibrationCommand */
+    uint8_t calibrationCommand = 0;
+    /** Sensor the others are calibrated against */
+    uint8_t calibrationReference = 0;
+    /** Number of samples averaged by a calibration */
+    uint8_t calibrationSamples = DEFAULT_CALIBRATION_SAMPLES;
+    /** Progress of the last command, a CalibrationState */
+    uint8_t calibrationState = 0;
+    /** Offset of each sensor in centi-celsius, as read back from the sensor or to be applied */
+    int16_t calibrationOffsets[NUM_TEMP_SENSORS] = {};
+    /** CalibrationStatus of each sensor */
+    uint8_t calibrationStatus[NUM_TEMP_SENSORS] = {};
+
+    /** Whether the running calibration programs the offsets into EEPROM */
+    bool calibrationPersist = false;
+    /** Whether a sensor had no valid readings in the running calibration */
+    bool calibrationIncomplete = false;
+    /** Samples taken by the running calibration */
+    uint8_t calibrationTaken = 0;
+    /** Time of the last calibration sample, or of the start of applying */
+    uint32_t calibrationLastMs = 0;
+    /** Sum of the differences from the reference for each sensor */
+    int32_t calibrationSums[NUM_TEMP_SENSORS] = {};
+    /** Number of valid differences from the reference for each sensor */
+    uint8_t calibrationCounts[NUM_TEMP_SENSORS] = {};
+
+    /**
+     * Accept a calibration command written over SDO, advance the running calibration and report the sensors' status
+     */
+    void processCalibration();
+
+    /**
+     * Start a calibration command
+     *
+     * @param command Command to start
+     */
+    void startCalibration(CalibrationCommand command);
+
+    /**
+     * Take one calibration sample from the sensor temperatures, then compute and request the offsets once enough are
+     * taken
+     */
+    void sampleCalibration();
+
+    /**
+     * Set the calibration state
+     *
+     * @param state New state
+     */
+    void setCalibrationState(CalibrationState state);
+
     /**
      * Have to know the size of the object dictionary for initialization
-     * process
+     * process. Objects with a sub-index per sensor grow it by one entry per sensor.
      */
-    static constexpr uint16_t OBJECT_DICTIONARY_SIZE = 63;
+    static constexpr uint16_t OBJECT_DICTIONARY_SIZE = 72 + 5 * NUM_TEMP_SENSORS;
+
+    // The CANopen node is told the dictionary size through getNumElements()
+    static_assert(OBJECT_DICTIONARY_SIZE <= UINT8_MAX, "Object dictionary size must fit in getNumElements()");
 
     CO_OBJ_T objectDictionary[OBJECT_DICTIONARY_SIZE + 1] = {
         MANDATORY_IDENTIFICATION_ENTRIES_1000_1014,
@@ -153,47 +442,86 @@ private:
         TRANSMIT_PDO_MAPPING_ENTRY_1AXX(0, 1, PDO_MAPPING_UNSIGNED16),
         TRANSMIT_PDO_MAPPING_ENTRY_1AXX(0, 2, PDO_MAPPING_UNSIGNED16),
 
-        // TPDO0 mapping for 4 temps
+        // TPDO1 mapping for 4 temps, TPDO slots 0-3, writable to choose the sensors
         TRANSMIT_PDO_MAPPING_START_KEY_1AXX(1, 4),
-        TRANSMIT_PDO_MAPPING_ENTRY_1AXX(1, 1, PDO_MAPPING_UNSIGNED16),
-        TRANSMIT_PDO_MAPPING_ENTRY_1AXX(1, 2, PDO_MAPPING_UNSIGNED16),
-        TRANSMIT_PDO_MAPPING_ENTRY_1AXX(1, 3, PDO_MAPPING_UNSIGNED16),
-        TRANSMIT_PDO_MAPPING_ENTRY_1AXX(1, 4, PDO_MAPPING_UNSIGNED16),
+        TRANSMIT_PDO_MAPPING_ENTRY_RW_1AXX(1, 1, &pdoMappings[0]),
+        TRANSMIT_PDO_MAPPING_ENTRY_RW_1AXX(1, 2, &pdoMappings[1]),
+        TRANSMIT_PDO_MAPPING_ENTRY_RW_1AXX(1, 3, &pdoMappings[2]),
+        TRANSMIT_PDO_MAPPING_ENTRY_RW_1AXX(1, 4, &pdoMappings[3]),
 
-        // TPDO1 mapping for next 4 temps
+        // TPDO2 mapping for next 4 temps, TPDO slots 4-7, writable to choose the sensors
         TRANSMIT_PDO_MAPPING_START_KEY_1AXX(2, 4),
-        TRANSMIT_PDO_MAPPING_ENTRY_1AXX(2, 1, PDO_MAPPING_UNSIGNED16),
-        TRANSMIT_PDO_MAPPING_ENTRY_1AXX(2, 2, PDO_MAPPING_UNSIGNED16),
-        TRANSMIT_PDO_MAPPING_ENTRY_1AXX(2, 3, PDO_MAPPING_UNSIGNED16),
-        TRANSMIT_PDO_MAPPING_ENTRY_1AXX(2, 4, PDO_MAPPING_UNSIGNED16),
+        TRANSMIT_PDO_MAPPING_ENTRY_RW_1AXX(2, 1, &pdoMappings[4]),
+        TRANSMIT_PDO_MAPPING_ENTRY_RW_1AXX(2, 2, &pdoMappings[5]),
+        TRANSMIT_PDO_MAPPING_ENTRY_RW_1AXX(2, 3, &pdoMappings[6]),
+        TRANSMIT_PDO_MAPPING_ENTRY_RW_1AXX(2, 4, &pdoMappings[7]),
 
         // Data link 0 for flow rate
         DATA_LINK_START_KEY_21XX(0, 2),
         DATA_LINK_21XX(0, 1, CO_TUNSIGNED16, &flowRate[0]),
         DATA_LINK_21XX(0, 2, CO_TUNSIGNED16, &flowRate[1]),
 
-        // Data link 1 for temps
-        DATA_LINK_START_KEY_21XX(1, 4),
-        DATA_LINK_21XX(1, 1, CO_TSIGNED16, &sensorTemps[0]), // On-board sensor
-        DATA_LINK_21XX(1, 2, CO_TSIGNED16, &sensorTemps[1]),
-        DATA_LINK_21XX(1, 3, CO_TSIGNED16, &sensorTemps[2]),
-        DATA_LINK_21XX(1, 4, CO_TSIGNED16, &sensorTemps[3]),
+        // Data link 1 for the temperature of each sensor, mapped by the temperature TPDOs
+        DATA_LINK_START_KEY_21XX(1, NUM_TEMP_SENSORS),
+        TMS_REPEAT(NUM_TEMP_SENSORS, SENSOR_DATA_LINK_21XX, 1, CO_TSIGNED16, publishedTemps)
 
-        // Data link 2 for temps
-        DATA_LINK_START_KEY_21XX(2, 4),
-        DATA_LINK_21XX(2, 1, CO_TSIGNED16, &sensorTemps[4]),
-        DATA_LINK_21XX(2, 2, CO_TSIGNED16, &sensorTemps[0]), // UNUSED
-        DATA_LINK_21XX(2, 3, CO_TSIGNED16, &sensorTemps[0]), // UNUSED
-        DATA_LINK_21XX(2, 4, CO_TSIGNED16, &sensorTemps[0]), // UNUSED
+        // Data link 2 for the empty object, mapped by temperature TPDO slots that carry no sensor
+        DATA_LINK_START_KEY_21XX(2, 1),
+        DATA_LINK_21XX(2, 1, CO_TSIGNED16, &emptySlotTemp),
 
         // Pump Command at 0x2200
         DATA_LINK_START_KEY_21XX(0x100, 2),
         DATA_LINK_21XX(0x100, 1, CO_TUNSIGNED8, &pumpSpeed[0]),
         DATA_LINK_21XX(0x100, 2, CO_TUNSIGNED8, &pumpSpeed[1]),
 
+        // Calibration command, reference sensor, number of samples and state at 0x2400
+        DATA_LINK_START_KEY_21XX(0x300, 4),
+        DATA_LINK_21XX(0x300, 1, CO_TUNSIGNED8, &calibrationCommand),
+        DATA_LINK_21XX(0x300, 2, CO_TUNSIGNED8, &calibrationReference),
+        DATA_LINK_21XX(0x300, 3, CO_TUNSIGNED8, &calibrationSamples),
+        DATA_LINK_21XX(0x300, 4, CO_TUNSIGNED8, &calibrationState),
+
+        // Temperature offset of each sensor at 0x2401
+        DATA_LINK_START_KEY_21XX(0x301, NUM_TEMP_SENSORS),
+        TMS_REPEAT(NUM_TEMP_SENSORS, SENSOR_DATA_LINK_21XX, 0x301, CO_TSIGNED16, calibrationOffsets)
+
+        // Calibration status of each sensor at 0x2402
+        DATA_LINK_START_KEY_21XX(0x302, NUM_TEMP_SENSORS),
+        TMS_REPEAT(NUM_TEMP_SENSORS, SENSOR_DATA_LINK_21XX, 0x302, CO_TUNSIGNED8, calibrationStatus)
+
+        // Minimum and maximum poll period and allowed change between reads at 0x2500
+        DATA_LINK_START_KEY_21XX(0x400, 3),
+        DATA_LINK_21XX(0x400, 1, CO_TUNSIGNED16, &minPollPeriod),
+        DATA_LINK_21XX(0x400, 2, CO_TUNSIGNED16, &maxPollPeriod),
+        DATA_LINK_21XX(0x400, 3, CO_TUNSIGNED16, &pollStep),
+
+        // Measured poll period of each sensor at 0x2501
+        DATA_LINK_START_KEY_21XX(0x401, NUM_TEMP_SENSORS),
+        TMS_REPEAT(NUM_TEMP_SENSORS, SENSOR_DATA_LINK_21XX, 0x401, CO_TUNSIGNED16, pollPeriods)
+
+        // Rate of change of each sensor at 0x2502
+        DATA_LINK_START_KEY_21XX(0x402, NUM_TEMP_SENSORS),
+        TMS_REPEAT(NUM_TEMP_SENSORS, SENSOR_DATA_LINK_21XX, 0x402, CO_TSIGNED16, temperatureRates)
+
+        // Sequence number and time of the sweep in the temperature TPDOs at 0x2600
+        DATA_LINK_START_KEY_21XX(0x500, 2),
+        DATA_LINK_21XX(0x500, 1, CO_TUNSIGNED32, &pdoSequence),
+        DATA_LINK_21XX(0x500, 2, CO_TUNSIGNED32, &pdoSweepMs),
+
         // End of dictionary marker
         CO_OBJ_DICT_ENDMARK,
     };
+
+    // The stack packs the TPDOs from the mappings above, the DBC the host tools decode them with must agree
+    static_assert(can::FLOW_TPDO::ID == 0x180 + NODE_ID, "FLOW_TPDO in TMS.dbc is not TPDO0 of this node");
+    static_assert(can::TEMP1_TPDO::ID == 0x280 + NODE_ID, "TEMP1_TPDO in TMS.dbc is not TPDO1 of this node");
+    static_assert(can::TEMP2_TPDO::ID == 0x380 + NODE_ID, "TEMP2_TPDO in TMS.dbc is not TPDO2 of this node");
+    static_assert(can::Heartbeat::ID == 0x700 + NODE_ID, "Heartbeat in TMS.dbc is not the heartbeat of this node");
+    static_assert(matchesPDOMapping16<can::FLOW_TPDO>(2), "FLOW_TPDO in TMS.dbc does not match the TPDO0 mapping");
+    static_assert(matchesPDOMapping16<can::TEMP1_TPDO>(4), "TEMP1_TPDO in TMS.dbc does not match the TPDO1 mapping");
+    static_assert(matchesPDOMapping16<can::TEMP2_TPDO>(4), "TEMP2_TPDO in TMS.dbc does not match the TPDO2 mapping");
+    static_assert(can::TEMP1_TPDO::NUM_SIGNALS + can::TEMP2_TPDO::NUM_SIGNALS == NUM_TEMP_PDO_SLOTS,
+                  "TMS.dbc does not have a signal for every temperature TPDO slot");
 };
 
 } // namespace TMS
@@ -0,0 +1,105 @@
+#ifndef TMS_TRIPLEBUFFER_HPP
+#define TMS_TRIPLEBUFFER_HPP
+
+#include <atomic>
+#include <cstdint>
+
+namespace TMS {
+
+/**
+ * Lock-free publication of a value from one producer to one consumer. The producer fills the back buffer and publishes
+ * it as a whole, the consumer reads a front buffer that only changes when it asks for the latest one, so the consumer
+ * never sees a value with parts from two publications. Each publication gets the next sequence number.
+ *
+ * The buffers are handed over by exchanging a single byte, so either side may run in an interrupt without interrupts
+ * being disabled on the other. The producer never waits: a publication the consumer has not picked up yet is replaced
+ * by the next one.
+ *
+ * @tparam T Type of the published value
+ */
+template<typename T>
+class TripleBuffer {
+public:
+    /**
+     * Construct the buffer with every slot holding the same value, read as sequence 0
+     *
+     * @param[in] initial Value the consumer reads until the first publication
+     */
+    explicit TripleBuffer(const T& initial) : buffers{initial, initial, initial} {}
+
+    /**
+     * Get the buffer to fill, owned by the producer until publish()
+     *
+     * @return The back buffer
+     */
+    T& back() {
+        return buffers[backIndex];
+    }
+
+    /**
+     * Hand the back buffer over to the consumer and take the next one to fill. The new back buffer holds an older
+     * publication, not the one just published.
+     */
+    void publish() {
+        sequences[backIndex] = ++published;
+        // Release the filled buffer to the consumer, acquire the one it last gave back
+        backIndex = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /**
+     * Swap in the latest publication as the front buffer, if there is one the consumer has not seen
+     *
+     * @return Whether the front buffer changed
+     */
+    bool update() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+        frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * Get the front buffer, which stays the same until the next update()
+     *
+     * @return The front buffer
+     */
+    const T& front() const {
+        return buffers[frontIndex];
+    }
+
+    /**
+     * Get the sequence number of the front buffer
+     *
+     * @return Number of the publication in the front buffer, counting from 1
+     */
+    uint32_t sequence() const {
+        return sequences[frontIndex];
+    }
+
+private:
+    /** Bits of the middle byte holding the index of a buffer */
+    static constexpr uint8_t INDEX_MASK = 0x03;
+
+    /** Bit of the middle byte set while the buffer there has not been picked up by the consumer */
+    static constexpr uint8_t FRESH = 0x04;
+
+    static_assert(std::atomic<uint8_t>::is_always_lock_free, "Buffers must be handed over without locking");
+
+    /** The three buffers, each either the back, middle or front buffer */
+    T buffers[3];
+    /** Sequence number of the publication in each buffer */
+    uint32_t sequences[3] = {};
+    /** Number of publications, only touched by the producer */
+    uint32_t published = 0;
+    /** Buffer being filled, only touched by the producer */
+    uint8_t backIndex = 0;
+    /** Buffer being read, only touched by the consumer */
+    uint8_t frontIndex = 1;
+    /** Buffer between the two, with FRESH set while it holds an unread publication */
+    std::atomic<uint8_t> middle{2};
+};
+
+} // namespace TMS
+
+#endif // TMS_TRIPLEBUFFER_HPP
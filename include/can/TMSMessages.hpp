@@ -0,0 +1,505 @@
+// Generated by tools/dbcgen/dbcgen.py from TMS.dbc. Do not edit, regenerate
+// with the can-messages target of the host build instead.
+#ifndef TMS_CAN_TMSMESSAGES_HPP
+#define TMS_CAN_TMSMESSAGES_HPP
+
+#include <cstdint>
+
+namespace TMS::can {
+
+/**
+ * Layout and scaling of a signal. Physical value = raw * scale + offset.
+ */
+struct Signal {
+    const char* name;
+    const char* unit;
+    /** Start bit as written in the DBC, the MSB for big-endian signals */
+    uint8_t start;
+    uint8_t length;
+    bool littleEndian;
+    bool isSigned;
+    double scale;
+    double offset;
+    double minimum;
+    double maximum;
+};
+
+/**
+ * A generated message, for tools that handle every message alike
+ */
+struct Message {
+    const char* name;
+    uint32_t id;
+    bool extended;
+    uint8_t length;
+    const Signal* signals;
+    uint8_t numSignals;
+    /** Decode a payload into numSignals raw values */
+    void (*unpackRaw)(const uint8_t* data, int64_t* raw);
+};
+
+namespace detail {
+
+/** Payload as a little-endian word, byte 0 in the low bits */
+constexpr uint64_t loadLE(const uint8_t* data, uint8_t length) {
+    uint64_t word = 0;
+    for (uint8_t i = 0; i < length; i++) {
+        word |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+    return word;
+}
+
+/** Payload as a big-endian word, byte 0 in the high bits */
+constexpr uint64_t loadBE(const uint8_t* data, uint8_t length) {
+    uint64_t word = 0;
+    for (uint8_t i = 0; i < length; i++) {
+        word |= static_cast<uint64_t>(data[i]) << (56 - 8 * i);
+    }
+    return word;
+}
+
+/** Merge a little-endian word into the payload */
+constexpr void storeLE(uint64_t word, uint8_t* data, uint8_t length) {
+    for (uint8_t i = 0; i < length; i++) {
+        data[i] |= static_cast<uint8_t>(word >> (8 * i));
+    }
+}
+
+/** Merge a big-endian word into the payload */
+constexpr void storeBE(uint64_t word, uint8_t* data, uint8_t length) {
+    for (uint8_t i = 0; i < length; i++) {
+        data[i] |= static_cast<uint8_t>(word >> (56 - 8 * i));
+    }
+}
+
+/** Clear the payload */
+constexpr void zero(uint8_t* data, uint8_t length) {
+    for (uint8_t i = 0; i < length; i++) {
+        data[i] = 0;
+    }
+}
+
+/** Sign extend the low bits of a raw value */
+constexpr int64_t signExtend(uint64_t raw, uint8_t bits) {
+    uint64_t sign = 1ull << (bits - 1);
+    return static_cast<int64_t>((raw ^ sign) - sign);
+}
+
+static_assert(signExtend(0x7FF, 12) == 2047);
+static_assert(signExtend(0x800, 12) == -2048);
+static_assert(signExtend(0xFFF, 12) == -1);
+static_assert(signExtend(0x1, 1) == -1);
+static_assert(signExtend(0x8000000000000000ull, 64) == INT64_MIN);
+static_assert(signExtend(0xFFFFFFFFFFFFFFFFull, 64) == -1);
+
+} // namespace detail
+
+/**
+ * FLOW_TPDO, sent by TMS
+ */
+struct FLOW_TPDO {
+    static constexpr uint32_t ID         = 0x182;
+    static constexpr bool EXTENDED       = false;
+    static constexpr uint8_t LENGTH      = 4;
+    static constexpr uint8_t NUM_SIGNALS = 2;
+
+    /** TPDO2Flow1, raw value, [0, 255] duty_cycle */
+    int16_t TPDO2Flow1 = 0;
+
+    /** TPDO2Flow2, raw value, [0, 255] duty_cycle */
+    int16_t TPDO2Flow2 = 0;
+
+    /** Layout of each signal, in member order */
+    static constexpr Signal SIGNALS[NUM_SIGNALS] = {
+        {"TPDO2Flow1", "duty_cycle", 0, 16, true, true, 1.0, 0.0, 0.0, 255.0},
+        {"TPDO2Flow2", "duty_cycle", 16, 16, true, true, 1.0, 0.0, 0.0, 255.0},
+    };
+
+    /**
+     * Decode a payload
+     *
+     * @param[in] data LENGTH bytes of payload
+     * @return The decoded message
+     */
+    static constexpr FLOW_TPDO unpack(const uint8_t* data) {
+        uint64_t le = detail::loadLE(data, LENGTH);
+        FLOW_TPDO message;
+        message.TPDO2Flow1 = static_cast<int16_t>(detail::signExtend((le >> 0) & 0xFFFFull, 16));
+        message.TPDO2Flow2 = static_cast<int16_t>(detail::signExtend((le >> 16) & 0xFFFFull, 16));
+        return message;
+    }
+
+    /**
+     * Encode the message
+     *
+     * @param[out] data LENGTH bytes of payload
+     */
+    constexpr void pack(uint8_t* data) const {
+        uint64_t le = 0;
+        le |= (static_cast<uint64_t>(TPDO2Flow1) & 0xFFFFull) << 0;
+        le |= (static_cast<uint64_t>(TPDO2Flow2) & 0xFFFFull) << 16;
+        detail::zero(data, LENGTH);
+        detail::storeLE(le, data, LENGTH);
+    }
+
+    /**
+     * Decode a payload into raw signal values, for tools that handle every message alike
+     *
+     * @param[in] data LENGTH bytes of payload
+     * @param[out] raw NUM_SIGNALS values, in member order
+     */
+    static constexpr void unpackRaw(const uint8_t* data, int64_t* raw) {
+        FLOW_TPDO message = unpack(data);
+        raw[0] = message.TPDO2Flow1;
+        raw[1] = message.TPDO2Flow2;
+    }
+
+    /**
+     * Check that a message is unchanged by pack() and unpack()
+     *
+     * @param[in] message Message to encode and decode
+     * @return Whether every signal decodes to what was encoded
+     */
+    static constexpr bool roundTrips(const FLOW_TPDO& message) {
+        uint8_t data[8] = {};
+        message.pack(data);
+        FLOW_TPDO unpacked = unpack(data);
+        return unpacked.TPDO2Flow1 == message.TPDO2Flow1
+            && unpacked.TPDO2Flow2 == message.TPDO2Flow2;
+    }
+};
+
+static_assert(FLOW_TPDO::roundTrips({-32768, 0}));
+static_assert(FLOW_TPDO::roundTrips({-1, 0}));
+static_assert(FLOW_TPDO::roundTrips({32767, 0}));
+static_assert(FLOW_TPDO::roundTrips({0, -32768}));
+static_assert(FLOW_TPDO::roundTrips({0, -1}));
+static_assert(FLOW_TPDO::roundTrips({0, 32767}));
+static_assert(FLOW_TPDO::roundTrips({-1, -1}));
+
+/**
+ * TEMP1_TPDO, sent by TMS
+ */
+struct TEMP1_TPDO {
+    static constexpr uint32_t ID         = 0x282;
+    static constexpr bool EXTENDED       = false;
+    static constexpr uint8_t LENGTH      = 8;
+    static constexpr uint8_t NUM_SIGNALS = 4;
+
+    /** TEMP1_TPDOBoard, raw value, [-25600, 25599] centiCelcius */
+    int16_t TEMP1_TPDOBoard = 0;
+
+    /** TEMP1_TPDOT0, raw value, [-25600, 25599] centiCelcius */
+    int16_t TEMP1_TPDOT0 = 0;
+
+    /** TEMP1_TPDOT1, raw value, [-25600, 25599] centiCelcius */
+    int16_t TEMP1_TPDOT1 = 0;
+
+    /** TEMP1_TPDOT2, raw value, [-25600, 25599] centiCelcius */
+    int16_t TEMP1_TPDOT2 = 0;
+
+    /** Layout of each signal, in member order */
+    static constexpr Signal SIGNALS[NUM_SIGNALS] = {
+        {"TEMP1_TPDOBoard", "centiCelcius", 0, 16, true, true, 1.0, 0.0, -25600.0, 25599.0},
+        {"TEMP1_TPDOT0", "centiCelcius", 16, 16, true, true, 1.0, 0.0, -25600.0, 25599.0},
+        {"TEMP1_TPDOT1", "centiCelcius", 32, 16, true, true, 1.0, 0.0, -25600.0, 25599.0},
+        {"TEMP1_TPDOT2", "centiCelcius", 48, 16, true, true, 1.0, 0.0, -25600.0, 25599.0},
+    };
+
+    /**
+     * Decode a payload
+     *
+     * @param[in] data LENGTH bytes of payload
+     * @return The decoded message
+     */
+    static constexpr TEMP1_TPDO unpack(const uint8_t* data) {
+        uint64_t le = detail::loadLE(data, LENGTH);
+        TEMP1_TPDO message;
+        message.TEMP1_TPDOBoard = static_cast<int16_t>(detail::signExtend((le >> 0) & 0xFFFFull, 16));
+        message.TEMP1_TPDOT0    = static_cast<int16_t>(detail::signExtend((le >> 16) & 0xFFFFull, 16));
+        message.TEMP1_TPDOT1    = static_cast<int16_t>(detail::signExtend((le >> 32) & 0xFFFFull, 16));
+        message.TEMP1_TPDOT2    = static_cast<int16_t>(detail::signExtend((le >> 48) & 0xFFFFull, 16));
+        return message;
+    }
+
+    /**
+     * Encode the message
+     *
+     * @param[out] data LENGTH bytes of payload
+     */
+    constexpr void pack(uint8_t* data) const {
+        uint64_t le = 0;
+        le |= (static_cast<uint64_t>(TEMP1_TPDOBoard) & 0xFFFFull) << 0;
+        le |= (static_cast<uint64_t>(TEMP1_TPDOT0) & 0xFFFFull) << 16;
+        le |= (static_cast<uint64_t>(TEMP1_TPDOT1) & 0xFFFFull) << 32;
+        le |= (static_cast<uint64_t>(TEMP1_TPDOT2) & 0xFFFFull) << 48;
+        detail::zero(data, LENGTH);
+        detail::storeLE(le, data, LENGTH);
+    }
+
+    /**
+     * Decode a payload into raw signal values, for tools that handle every message alike
+     *
+     * @param[in] data LENGTH bytes of payload
+     * @param[out] raw NUM_SIGNALS values, in member order
+     */
+    static constexpr void unpackRaw(const uint8_t* data, int64_t* raw) {
+        TEMP1_TPDO message = unpack(data);
+        raw[0] = message.TEMP1_TPDOBoard;
+        raw[1] = message.TEMP1_TPDOT0;
+        raw[2] = message.TEMP1_TPDOT1;
+        raw[3] = message.TEMP1_TPDOT2;
+    }
+
+    /**
+     * Check that a message is unchanged by pack() and unpack()
+     *
+     * @param[in] message Message to encode and decode
+     * @return Whether every signal decodes to what was encoded
+     */
+    static constexpr bool roundTrips(const TEMP1_TPDO& message) {
+        uint8_t data[8] = {};
+        message.pack(data);
+        TEMP1_TPDO unpacked = unpack(data);
+        return unpacked.TEMP1_TPDOBoard == message.TEMP1_TPDOBoard
+            && unpacked.TEMP1_TPDOT0 == message.TEMP1_TPDOT0
+            && unpacked.TEMP1_TPDOT1 == message.TEMP1_TPDOT1
+            && unpacked.TEMP1_TPDOT2 == message.TEMP1_TPDOT2;
+    }
+};
+
+static_assert(TEMP1_TPDO::roundTrips({-32768, 0, 0, 0}));
+static_assert(TEMP1_TPDO::roundTrips({-1, 0, 0, 0}));
+static_assert(TEMP1_TPDO::roundTrips({32767, 0, 0, 0}));
+static_assert(TEMP1_TPDO::roundTrips({0, -32768, 0, 0}));
+static_assert(TEMP1_TPDO::roundTrips({0, -1, 0, 0}));
+static_assert(TEMP1_TPDO::roundTrips({0, 32767, 0, 0}));
+static_assert(TEMP1_TPDO::roundTrips({0, 0, -32768, 0}));
+static_assert(TEMP1_TPDO::roundTrips({0, 0, -1, 0}));
+static_assert(TEMP1_TPDO::roundTrips({0, 0, 32767, 0}));
+static_assert(TEMP1_TPDO::roundTrips({0, 0, 0, -32768}));
+static_assert(TEMP1_TPDO::roundTrips({0, 0, 0, -1}));
+static_assert(TEMP1_TPDO::roundTrips({0, 0, 0, 32767}));
+static_assert(TEMP1_TPDO::roundTrips({-1, -1, -1, -1}));
+
+/**
+ * TEMP2_TPDO, sent by TMS
+ */
+struct TEMP2_TPDO {
+    static constexpr uint32_t ID         = 0x382;
+    static constexpr bool EXTENDED       = false;
+    static constexpr uint8_t LENGTH      = 8;
+    static constexpr uint8_t NUM_SIGNALS = 4;
+
+    /** TEMP2_TPDOT3, raw value, [-25600, 25599] centiCelcius */
+    int16_t TEMP2_TPDOT3 = 0;
+
+    /** TEMP2_TPDOT4, raw value, [-25600, 25599] centiCelcius */
+    int16_t TEMP2_TPDOT4 = 0;
+
+    /** TEMP2_TPDOT5, raw value, [-25600, 25599] centiCelcius */
+    int16_t TEMP2_TPDOT5 = 0;
+
+    /** TEMP2_TPDOT6, raw value, [-25600, 25599] centiCelcius */
+    int16_t TEMP2_TPDOT6 = 0;
+
+    /** Layout of each signal, in member order */
+    static constexpr Signal SIGNALS[NUM_SIGNALS] = {
+        {"TEMP2_TPDOT3", "centiCelcius", 0, 16, true, true, 1.0, 0.0, -25600.0, 25599.0},
+        {"TEMP2_TPDOT4", "centiCelcius", 16, 16, true, true, 1.0, 0.0, -25600.0, 25599.0},
+        {"TEMP2_TPDOT5", "centiCelcius", 32, 16, true, true, 1.0, 0.0, -25600.0, 25599.0},
+        {"TEMP2_TPDOT6", "centiCelcius", 48, 16, true, true, 1.0, 0.0, -25600.0, 25599.0},
+    };
+
+    /**
+     * Decode a payload
+     *
+     * @param[in] data LENGTH bytes of payload
+     * @return The decoded message
+     */
+    static constexpr TEMP2_TPDO unpack(const uint8_t* data) {
+        uint64_t le = detail::loadLE(data, LENGTH);
+        TEMP2_TPDO message;
+        message.TEMP2_TPDOT3 = static_cast<int16_t>(detail::signExtend((le >> 0) & 0xFFFFull, 16));
+        message.TEMP2_TPDOT4 = static_cast<int16_t>(detail::signExtend((le >> 16) & 0xFFFFull, 16));
+        message.TEMP2_TPDOT5 = static_cast<int16_t>(detail::signExtend((le >> 32) & 0xFFFFull, 16));
+        message.TEMP2_TPDOT6 = static_cast<int16_t>(detail::signExtend((le >> 48) & 0xFFFFull, 16));
+        return message;
+    }
+
+    /**
+     * Encode the message
+     *
+     * @param[out] data LENGTH bytes of payload
+     */
+    constexpr void pack(uint8_t* data) const {
+        uint64_t le = 0;
+        le |= (static_cast<uint64_t>(TEMP2_TPDOT3) & 0xFFFFull) << 0;
+        le |= (static_cast<uint64_t>(TEMP2_TPDOT4) & 0xFFFFull) << 16;
+        le |= (static_cast<uint64_t>(TEMP2_TPDOT5) & 0xFFFFull) << 32;
+        le |= (static_cast<uint64_t>(TEMP2_TPDOT6) & 0xFFFFull) << 48;
+        detail::zero(data, LENGTH);
+        detail::storeLE(le, data, LENGTH);
+    }
+
+    /**
+     * Decode a payload into raw signal values, for tools that handle every message alike
+     *
+     * @param[in] data LENGTH bytes of payload
+     * @param[out] raw NUM_SIGNALS values, in member order
+     */
+    static constexpr void unpackRaw(const uint8_t* data, int64_t* raw) {
+        TEMP2_TPDO message = unpack(data);
+        raw[0] = message.TEMP2_TPDOT3;
+        raw[1] = message.TEMP2_TPDOT4;
+        raw[2] = message.TEMP2_TPDOT5;
+        raw[3] = message.TEMP2_TPDOT6;
+    }
+
+    /**
+     * Check that a message is unchanged by pack() and unpack()
+     *
+     * @param[in] message Message to encode and decode
+     * @return Whether every signal decodes to what was encoded
+     */
+    static constexpr bool roundTrips(const TEMP2_TPDO& message) {
+        uint8_t data[8] = {};
+        message.pack(data);
+        TEMP2_TPDO unpacked = unpack(data);
+        return unpacked.TEMP2_TPDOT3 == message.TEMP2_TPDOT3
+            && unpacked.TEMP2_TPDOT4 == message.TEMP2_TPDOT4
+            && unpacked.TEMP2_TPDOT5 == message.TEMP2_TPDOT5
+            && unpacked.TEMP2_TPDOT6 == message.TEMP2_TPDOT6;
+    }
+};
+
+static_assert(TEMP2_TPDO::roundTrips({-32768, 0, 0, 0}));
+static_assert(TEMP2_TPDO::roundTrips({-1, 0, 0, 0}));
+static_assert(TEMP2_TPDO::roundTrips({32767, 0, 0, 0}));
+static_assert(TEMP2_TPDO::roundTrips({0, -32768, 0, 0}));
+static_assert(TEMP2_TPDO::roundTrips({0, -1, 0, 0}));
+static_assert(TEMP2_TPDO::roundTrips({0, 32767, 0, 0}));
+static_assert(TEMP2_TPDO::roundTrips({0, 0, -32768, 0}));
+static_assert(TEMP2_TPDO::roundTrips({0, 0, -1, 0}));
+static_assert(TEMP2_TPDO::roundTrips({0, 0, 32767, 0}));
+static_assert(TEMP2_TPDO::roundTrips({0, 0, 0, -32768}));
+static_assert(TEMP2_TPDO::roundTrips({0, 0, 0, -1}));
+static_assert(TEMP2_TPDO::roundTrips({0, 0, 0, 32767}));
+static_assert(TEMP2_TPDO::roundTrips({-1, -1, -1, -1}));
+
+/**
+ * Heartbeat, sent by TMS
+ */
+struct Heartbeat {
+    static constexpr uint32_t ID         = 0x702;
+    static constexpr bool EXTENDED       = false;
+    static constexpr uint8_t LENGTH      = 1;
+    static constexpr uint8_t NUM_SIGNALS = 1;
+
+    /** Values of HeartbeatSig */
+    enum HeartbeatSigValue : uint8_t {
+        HeartbeatSig_Bootup         = 0,
+        HeartbeatSig_Stopped        = 4,
+        HeartbeatSig_Operational    = 5,
+        HeartbeatSig_Pre_Operationa = 127,
+    };
+
+    /** HeartbeatSig, raw value, [0, 127] */
+    uint8_t HeartbeatSig = 0;
+
+    /** Layout of each signal, in member order */
+    static constexpr Signal SIGNALS[NUM_SIGNALS] = {
+        {"HeartbeatSig", "", 7, 8, false, false, 1.0, 0.0, 0.0, 127.0},
+    };
+
+    /**
+     * Decode a payload
+     *
+     * @param[in] data LENGTH bytes of payload
+     * @return The decoded message
+     */
+    static constexpr Heartbeat unpack(const uint8_t* data) {
+        uint64_t be = detail::loadBE(data, LENGTH);
+        Heartbeat message;
+        message.HeartbeatSig = static_cast<uint8_t>((be >> 56) & 0xFFull);
+        return message;
+    }
+
+    /**
+     * Encode the message
+     *
+     * @param[out] data LENGTH bytes of payload
+     */
+    constexpr void pack(uint8_t* data) const {
+        uint64_t be = 0;
+        be |= (static_cast<uint64_t>(HeartbeatSig) & 0xFFull) << 56;
+        detail::zero(data, LENGTH);
+        detail::storeBE(be, data, LENGTH);
+    }
+
+    /**
+     * Decode a payload into raw signal values, for tools that handle every message alike
+     *
+     * @param[in] data LENGTH bytes of payload
+     * @param[out] raw NUM_SIGNALS values, in member order
+     */
+    static constexpr void unpackRaw(const uint8_t* data, int64_t* raw) {
+        Heartbeat message = unpack(data);
+        raw[0] = message.HeartbeatSig;
+    }
+
+    /**
+     * Check that a message is unchanged by pack() and unpack()
+     *
+     * @param[in] message Message to encode and decode
+     * @return Whether every signal decodes to what was encoded
+     */
+    static constexpr bool roundTrips(const Heartbeat& message) {
+        uint8_t data[8] = {};
+        message.pack(data);
+        Heartbeat unpacked = unpack(data);
+        return unpacked.HeartbeatSig == message.HeartbeatSig;
+    }
+};
+
+static_assert(Heartbeat::roundTrips({255}));
+static_assert(Heartbeat::roundTrips({255}));
+
+/** Every generated message, for tools that look messages up by identifier */
+inline constexpr Message MESSAGES[] = {
+    {"FLOW_TPDO",
+     FLOW_TPDO::ID,
+     FLOW_TPDO::EXTENDED,
+     FLOW_TPDO::LENGTH,
+     FLOW_TPDO::SIGNALS,
+     FLOW_TPDO::NUM_SIGNALS,
+     FLOW_TPDO::unpackRaw},
+    {"TEMP1_TPDO",
+     TEMP1_TPDO::ID,
+     TEMP1_TPDO::EXTENDED,
+     TEMP1_TPDO::LENGTH,
+     TEMP1_TPDO::SIGNALS,
+     TEMP1_TPDO::NUM_SIGNALS,
+     TEMP1_TPDO::unpackRaw},
+    {"TEMP2_TPDO",
+     TEMP2_TPDO::ID,
+     TEMP2_TPDO::EXTENDED,
+     TEMP2_TPDO::LENGTH,
+     TEMP2_TPDO::SIGNALS,
+     TEMP2_TPDO::NUM_SIGNALS,
+     TEMP2_TPDO::unpackRaw},
+    {"Heartbeat",
+     Heartbeat::ID,
+     Heartbeat::EXTENDED,
+     Heartbeat::LENGTH,
+     Heartbeat::SIGNALS,
+     Heartbeat::NUM_SIGNALS,
+     Heartbeat::unpackRaw},
+};
+
+/** Number of entries in MESSAGES */
+inline constexpr uint8_t NUM_MESSAGES = 4;
+
+} // namespace TMS::can
+
+#endif // TMS_CAN_TMSMESSAGES_HPP
@@ -25,6 +25,16 @@ public:
      * @return The last value
      */
     virtual uint32_t value() = 0;
+
+    /**
+     * Whether the device has work to do. Devices that are not due are left out of a mux sweep, and a mux bus without
+     * a due device is not selected.
+     *
+     * @return Whether to run the action on the next sweep
+     */
+    virtual bool due() {
+        return true;
+    }
 };
 
 } // namespace TMS
@@ -6,27 +6,36 @@
 #include <core/io/I2C.hpp>
 #include <dev/I2CDevice.hpp>
 
-#define I2C_MUX_BUS_SIZE 4
+#define I2C_MUX_BUS_SIZE     4
+#define I2C_MUX_MAX_BUS_SIZE 8
 
 namespace io = core::io;
 
 namespace TMS {
 /**
- * Represents the registers for setting the active bus on the TCA9545A
+ * Represents the bits of the control register for enabling each bus on the TCA954x. BUS_4 to BUS_7 only exist on the
+ * 8 channel parts (TCA9548A).
  */
 enum TCA954_BUS {
     BUS_0 = 0x01,
     BUS_1 = 0x02,
     BUS_2 = 0x04,
     BUS_3 = 0x08,
+    BUS_4 = 0x10,
+    BUS_5 = 0x20,
+    BUS_6 = 0x40,
+    BUS_7 = 0x80,
 };
 
 /**
  * Device driver for TCA9545A I2C Multiplexer. This allows multiple devices with the same address to be connected to
  * the same bus by switching between 4 sub-buses that can be connected to the microcontroller.
+ *
+ * The mux is itself an I2CDevice, so a mux at a different address can be placed on a bus of another mux to cascade
+ * them. Polling the parent then polls the child's buses while the parent's bus is selected.
  * Datasheet: datasheets/tca9545a.pdf
  */
-class TCA954MUX {
+class TCA954MUX : public I2CDevice {
 public:
     /**
      * Constructor for the TCA9545A driver
@@ -35,8 +44,10 @@ public:
      * @param[in] addr address of TCA
      * @param[in] buses array of buses containing I2CDevices
      * @param[in] numDevices Array with the number of devices on each bus
+     * @param[in] numBuses Number of buses on the part, 4 for the TCA9545A and up to 8 for the TCA9548A
      */
-    TCA954MUX(io::I2C& i2c, uint8_t addr, I2CDevice** buses[I2C_MUX_BUS_SIZE], uint8_t numDevices[I2C_MUX_BUS_SIZE]);
+    TCA954MUX(io::I2C& i2c, uint8_t addr, I2CDevice** buses[], uint8_t numDevices[],
+              uint8_t numBuses = I2C_MUX_BUS_SIZE);
 
     /**
      * Sets the active bus on the TCA9545A
@@ -48,10 +59,41 @@ public:
     io::I2C::I2CStatus setBus(uint8_t bus, bool toggled);
 
     /**
-     * Runs the actions on all attached I2CDevices connected to the mux bus
+     * Disconnects all buses from the upstream bus. Needed when several muxes share an upstream bus, otherwise the bus
+     * left selected on one mux stays connected while another mux is being polled. Nothing is written when no bus is
+     * connected.
+     *
+     * @return Result of the I2C write operation
+     */
+    io::I2C::I2CStatus disableAll();
+
+    /**
+     * Runs the actions on the attached I2CDevices that are due. Buses without a due device are not selected.
      */
     void pollAllDevices();
 
+    /**
+     * Polls all attached devices. Used when this mux is cascaded behind another mux.
+     *
+     * @param[in] skip Whether the upstream bus failed, in which case every attached device is skipped
+     * @return Status of selecting the last bus
+     */
+    io::I2C::I2CStatus action(bool skip) override;
+
+    /**
+     * Gets the last value written to the control register
+     *
+     * @return Mask of the enabled buses
+     */
+    uint32_t value() override;
+
+    /**
+     * Whether any attached device is due
+     *
+     * @return Whether a device on one of the buses is due
+     */
+    bool due() override;
+
 private:
     /**
      * I2C instance used to communicate
@@ -63,33 +105,57 @@ private:
      */
     uint8_t i2cSlaveAddress;
 
+    /**
+     * Number of buses on this part
+     */
+    uint8_t numBuses;
+
     /**
      * Array of devices on each bus
      */
-    I2CDevice** busDevices[I2C_MUX_BUS_SIZE];
+    I2CDevice** busDevices[I2C_MUX_MAX_BUS_SIZE] = {};
 
     /**
      * Array storing the number of devices on each bus
      */
-    uint8_t numDevices[I2C_MUX_BUS_SIZE];
+    uint8_t numDevices[I2C_MUX_MAX_BUS_SIZE] = {};
+
+    /**
+     * Last value written to the control register
+     */
+    uint8_t control = 0;
+
+    /**
+     * Runs the actions on the attached devices that are due, or on every attached device when skipping
+     *
+     * @param[in] skip Whether to skip every device without touching the bus
+     * @return Status of selecting the last bus
+     */
+    io::I2C::I2CStatus poll(bool skip);
+
+    /**
+     * Whether any device on a bus is due
+     *
+     * @param[in] bus The bus to check
+     * @return Whether the bus has to be selected
+     */
+    bool busDue(uint8_t bus);
 
     /**
-     * Writes a value to a register on the TCA9545A
+     * Writes the control register on the TCA9545A. The part has a single register, written by a one byte transfer.
      *
-     * @param[in] reg The register to write to
-     * @param[in] val The value to write to the register
+     * @param[in] val Mask of buses to enable
      * @return Result of the I2C write operation
      */
-    io::I2C::I2CStatus writeRegister(uint8_t reg, uint8_t val);
+    io::I2C::I2CStatus writeControl(uint8_t val);
 
     /**
-     * Reads a value from a register on the TCA9545A
+     * Reads the control register on the TCA9545A
      *
-     * @param[in] reg The register to read from
-     * @param[out] val The value read from the register
+     * @param[out] val Mask of the enabled buses
      * @return Result of the I2C read operation
      */
-    io::I2C::I2CStatus readRegister(uint8_t reg, uint8_t* val);
+    io::I2C::I2CStatus readControl(uint8_t* val);
 };
 
 } // namespace TMS
@@ -10,10 +10,44 @@ namespace TMS {
 
 /**
  * Temp sensor for TMS
+ *
+ * The sensor applies the value of its temperature offset register to every conversion, so calibration offsets cost no
+ * processing per sample. Offsets and the conversion configuration can be programmed into the sensor's EEPROM, which
+ * loads them into the registers at power up. The configuration is only programmed when the EEPROM is not known to hold
+ * it already, as read back at boot before the conversions were switched. Register writes are only made from action(), while the mux bus of the
+ * sensor is selected. Programming a register into EEPROM takes several milliseconds, so it is checked on the following
+ * actions rather than waited for, and the sensor is not read until it is done.
+ *
+ * Once given a poll period, the sensor is only due once per period, and its conversion cycle and averaging follow the
+ * period: the most averaging that still gives a new conversion on every read.
  * Datasheet: datasheets/tmp117.pdf
  */
 class TMP117 : public I2CDevice {
 public:
+    /**
+     * Calibration state of the sensor
+     */
+    enum class CalibrationStatus : uint8_t {
+        /** The offset and configuration have not been read back since boot */
+        UNVERIFIED = 0,
+        /** The offset and configuration loaded from EEPROM were read back at boot */
+        VERIFIED = 1,
+        /** An offset is waiting to be written on the next action */
+        PENDING = 2,
+        /** The offset register was written and read back */
+        APPLIED = 3,
+        /** The offset was also programmed into EEPROM, which holds the configuration as well */
+        PERSISTED = 4,
+        /** A transfer failed, a value read back did not match, or EEPROM programming timed out */
+        FAILED = 5,
+    };
+
+    /** Temperature reported when the sensor could not be read */
+    static constexpr int16_t ERROR_TEMP = -25600;
+
+    /** Power on value of the configuration register: continuous conversion, 1 s cycle, 8 averages */
+    static constexpr uint16_t DEFAULT_CONFIG = 0x0220;
+
     /**
      * Temp sensor constructor
      *
@@ -36,6 +70,78 @@ public:
      */
     io::I2C::I2CStatus readTemp(int16_t& temp);
 
+    /**
+     * Converts a raw temperature register value to degrees centi-celsius
+     *
+     * @param[in] raw the value read from the temperature register
+     * @return the temperature in degrees centi-celsius
+     */
+    static int16_t toCentiCelsius(int16_t raw);
+
+    /**
+     * Converts degrees centi-celsius to the nearest temperature or offset register value
+     *
+     * @param[in] centiCelsius the temperature in degrees centi-celsius
+     * @return the register value
+     */
+    static int16_t fromCentiCelsius(int16_t centiCelsius);
+
+    /**
+     * Write a new temperature offset on the next action, replacing any offset still waiting
+     *
+     * @param[in] centiCelsius Offset added to every conversion, in degrees centi-celsius
+     * @param[in] persist Whether to also program the offset, and the configuration if needed, into EEPROM
+     */
+    void requestOffset(int16_t centiCelsius, bool persist);
+
+    /**
+     * Read the offset and configuration back from the sensor on the next action
+     */
+    void requestVerify();
+
+    /**
+     * Gets the offset last read back from the sensor
+     *
+     * @return the offset in degrees centi-celsius
+     */
+    int16_t offset() const;
+
+    /**
+     * Gets the calibration state of the sensor
+     *
+     * @return the calibration state
+     */
+    CalibrationStatus calibrationStatus() const;
+
+    /**
+     * Set how often the sensor is read, and switch its conversions to match on the next action. Sensors without a
+     * poll period are read on every sweep and keep their conversion configuration.
+     *
+     * @param[in] periodMs Time between reads in milliseconds
+     */
+    void setPollPeriod(uint16_t periodMs);
+
+    /**
+     * Gets the time of the last read, successful or not
+     *
+     * @return time::millis() at the last read
+     */
+    uint32_t lastReadMs() const;
+
+    /**
+     * Gets the number of reads since boot, successful or not. Wraps around.
+     *
+     * @return the number of reads
+     */
+    uint16_t readCount() const;
+
+    /**
+     * Whether the poll period has passed since the last read, or a calibration request is waiting or in progress
+     *
+     * @return Whether to read the sensor on the next sweep
+     */
+    bool due() override;
+
     /**
      * Reads the sensor value and stores it in tempValue
      *
@@ -56,7 +162,60 @@ private:
      */
     static constexpr uint8_t TEMP_REG = 0x00;
 
-    static constexpr int16_t ERROR_TEMP = -25600;
+    /**
+     * Register for the conversion configuration
+     */
+    static constexpr uint8_t CONFIG_REG = 0x01;
+
+    /**
+     * EEPROM unlock register. While unlocked, writes to the configuration, limit and offset registers also program
+     * the EEPROM.
+     */
+    static constexpr uint8_t EEPROM_UL_REG = 0x04;
+
+    /**
+     * Register for the temperature offset, same format as the temperature register
+     */
+    static constexpr uint8_t TEMP_OFFSET_REG = 0x07;
+
+    /** EEPROM_UL bit that unlocks the EEPROM */
+    static constexpr uint16_t EEPROM_UNLOCK = 0x8000;
+
+    /** EEPROM_UL bit set while the EEPROM is being programmed */
+    static constexpr uint16_t EEPROM_BUSY = 0x4000;
+
+    /** Configuration bits that are programmed into EEPROM, the others are status flags and the soft reset */
+    static constexpr uint16_t SETTINGS_MASK = 0x0FFC;
+
+    /** Configuration bits for the conversion mode, cycle time and averaging */
+    static constexpr uint16_t CONVERSION_MASK = 0x0FE0;
+
+    /** Time allowed for programming one EEPROM register, typically 7 ms */
+    static constexpr uint32_t EEPROM_TIMEOUT_MS = 20;
+
+    /** Conversion bits for a 15.5 ms cycle without averaging */
+    static constexpr uint16_t CONVERSION_FAST = 0x0000;
+
+    /** Conversion bits for a 125 ms cycle of 8 averages */
+    static constexpr uint16_t CONVERSION_AVG_8 = 0x0020;
+
+    /** Conversion bits for a 500 ms cycle of 32 averages */
+    static constexpr uint16_t CONVERSION_AVG_32 = 0x0040;
+
+    /** Conversion bits for a 1 s cycle of 64 averages */
+    static constexpr uint16_t CONVERSION_AVG_64 = 0x0060;
+
+    /**
+     * Register being programmed into EEPROM
+     */
+    enum class EEPROMStep : uint8_t {
+        /** The EEPROM is locked */
+        IDLE,
+        /** The configuration is being programmed, the offset is next */
+        CONFIG,
+        /** The offset is being programmed */
+        OFFSET,
+    };
 
     /**
      * Device ID
@@ -77,6 +236,161 @@ private:
      * Internal variable to store temperature values in
      */
     int16_t lastTempValue;
+
+    /**
+     * Configuration expected at power up, programmed into EEPROM along with the offset
+     */
+    uint16_t config = DEFAULT_CONFIG;
+
+    /**
+     * Whether the EEPROM is known to hold config, as read back at boot or programmed
+     */
+    bool configStored = false;
+
+    /**
+     * Whether the configuration register has been written since boot, after which it no longer shows the EEPROM
+     */
+    bool configWritten = false;
+
+    /**
+     * Configuration for the poll period, written on the next action when the sensor holds a different one
+     */
+    uint16_t conversionConfig = DEFAULT_CONFIG;
+
+    /**
+     * Configuration the sensor holds, as last written or read back
+     */
+    uint16_t activeConfig = DEFAULT_CONFIG;
+
+    /**
+     * Time between reads in milliseconds, 0 to read on every sweep
+     */
+    uint16_t pollPeriodMs = 0;
+
+    /**
+     * time::millis() at the last read
+     */
+    uint32_t lastPollMs = 0;
+
+    /**
+     * Number of reads since boot
+     */
+    uint16_t reads = 0;
+
+    /**
+     * Offset read back from the sensor, in degrees centi-celsius
+     */
+    int16_t offsetValue = 0;
+
+    /**
+     * Offset waiting to be written, in degrees centi-celsius
+     */
+    int16_t pendingOffset = 0;
+
+    /**
+     * Whether the waiting offset is to be programmed into EEPROM
+     */
+    bool pendingPersist = false;
+
+    /**
+     * Whether an offset is waiting to be written
+     */
+    bool pending = false;
+
+    /**
+     * Whether the registers have been read back since boot or the last verify request
+     */
+    bool verified = false;
+
+    /**
+     * Calibration state
+     */
+    CalibrationStatus calibration = CalibrationStatus::UNVERIFIED;
+
+    /**
+     * Register being programmed into EEPROM, IDLE while the EEPROM is locked
+     */
+    EEPROMStep eepromStep = EEPROMStep::IDLE;
+
+    /**
+     * Offset register value being programmed into EEPROM
+     */
+    uint16_t eepromOffset = 0;
+
+    /**
+     * time::millis() when programming of the current EEPROM register started
+     */
+    uint32_t eepromStartMs = 0;
+
+    /**
+     * Read the offset and configuration registers back
+     *
+     * @return Whether both registers were read, the configuration may still not be the expected one
+     */
+    bool verify();
+
+    /**
+     * Write the waiting offset, or unlock the EEPROM and start programming it if the offset is to be persisted
+     */
+    void applyOffset();
+
+    /**
+     * Start programming a register into the unlocked EEPROM, locking it again if the write fails
+     *
+     * @param[in] reg Register to program
+     * @param[in] value Value to program
+     * @param[in] step Step the programming is at
+     * @return Whether the write was made
+     */
+    bool programEEPROM(uint8_t reg, uint16_t value, EEPROMStep step);
+
+    /**
+     * Check on the EEPROM register being programmed, and once it is done program the offset or lock the EEPROM
+     */
+    void continueEEPROM();
+
+    /**
+     * Lock the EEPROM and read the programmed offset back
+     *
+     * @param[in] programmed Whether every register was programmed
+     */
+    void finishEEPROM(bool programmed);
+
+    /**
+     * Read the offset register back and set the calibration state
+     *
+     * @param[in] raw Offset register value that was written
+     * @param[in] written Whether the offset was written without errors
+     * @param[in] success Calibration state if the offset read back matches
+     * @return Whether the offset register was read
+     */
+    bool readBackOffset(uint16_t raw, bool written, CalibrationStatus success);
+
+    /**
+     * Get the conversion bits for a poll period
+     *
+     * @param[in] periodMs Time between reads in milliseconds
+     * @return The conversion mode, cycle time and averaging bits of the configuration
+     */
+    static uint16_t conversionBits(uint16_t periodMs);
+
+    /**
+     * Write a register
+     *
+     * @param[in] reg Register to write
+     * @param[in] value Value to write
+     * @return I2CStatus of the write
+     */
+    io::I2C::I2CStatus writeRegister(uint8_t reg, uint16_t value);
+
+    /**
+     * Read a register
+     *
+     * @param[in] reg Register to read
+     * @param[out] value Value read
+     * @return I2CStatus of the read
+     */
+    io::I2C::I2CStatus readRegister(uint8_t reg, uint16_t& value);
 };
 
 } // namespace TMS
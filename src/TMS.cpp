@@ -2,8 +2,35 @@
 
 namespace TMS {
 
-TMS::TMS(int16_t* sensorTemps, TCA954MUX& tca954mux, Pump pumps[2])
-    : sensorTemps(sensorTemps), tca954mux(tca954mux), pumps{pumps[0], pumps[1]} {}
+TMS::TMS(int16_t* sensorTemps, TMP117* sensors[], TCA954MUX* muxes[], uint8_t numMuxes, Pump pumps[2])
+    : sensorTemps(sensorTemps), numMuxes(numMuxes < MAX_MUXES ? numMuxes : MAX_MUXES), pumps{pumps[0], pumps[1]},
+      sweeps(Sweep{}) {
+    if (numMuxes > MAX_MUXES) {
+        log::LOGGER.log(log::Logger::LogLevel::ERROR, "Only %d of %d muxes are polled", MAX_MUXES, numMuxes);
+    }
+    for (uint8_t i = 0; i < this->numMuxes; i++) {
+        this->muxes[i] = muxes[i];
+    }
+    for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+        this->sensors[i] = sensors[i];
+
+        // Start slow, the first reads show whether the temperatures are moving
+        acquisitionLastTemps[i] = TMP117::ERROR_TEMP;
+        this->sensors[i]->setPollPeriod(maxPollPeriod);
+    }
+
+    // Transmit the first sensors in order until the TPDOs are mapped differently over SDO
+    for (uint8_t i = 0; i < NUM_TEMP_PDO_SLOTS; i++) {
+        pdoMappings[i] = i < NUM_TEMP_SENSORS ? CO_LINK(0x2101, i + 1, PDO_MAPPING_UNSIGNED16)
+                                              : CO_LINK(0x2102, 1, PDO_MAPPING_UNSIGNED16);
+    }
+    updatePDOTemps();
+
+    ODStatus status = validateDictionary(objectDictionary, OBJECT_DICTIONARY_SIZE);
+    if (status != ODStatus::OK) {
+        log::LOGGER.log(log::Logger::LogLevel::ERROR, "Object dictionary is invalid: %d", static_cast<int>(status));
+    }
+}
 
 CO_OBJ_T* TMS::getObjectDictionary() {
     return &objectDictionary[0];
@@ -20,7 +47,22 @@ uint8_t TMS::getNodeID() {
 void TMS::process() {
     static uint32_t lastUpdate = 0;
 
-    tca954mux.pollAllDevices();
+    for (uint8_t i = 0; i < numMuxes; i++) {
+        muxes[i]->pollAllDevices();
+
+        // Muxes sharing the main bus must not leave a bus connected while the next one is polled
+        if (numMuxes > 1) {
+            muxes[i]->disableAll();
+        }
+    }
+
+    // Sweeps that read no sensor leave the last publication, so its sequence number counts sweeps with new readings
+    uint32_t readMs;
+    if (processAcquisition(readMs)) {
+        publishSweep(readMs);
+    }
+    processCalibration();
+
 #ifdef EVT_CORE_LOG_ENABLE
     if (time::millis() - lastUpdate > 100) {
         lastUpdate = time::millis();
@@ -65,4 +107,219 @@ void TMS::setMode(CO_MODE newMode) {
     mode = newMode;
 }
 
+void TMS::publishSweep(uint32_t readMs) {
+    Sweep& sweep = sweeps.back();
+    for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+        sweep.temps[i] = sensorTemps[i];
+    }
+    sweep.timeMs = readMs;
+    sweeps.publish();
+}
+
+void TMS::updatePDOTemps() {
+    sweeps.update();
+    const Sweep& sweep = sweeps.front();
+
+    for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+        publishedTemps[i] = sweep.temps[i];
+    }
+    pdoSequence = sweeps.sequence();
+    pdoSweepMs  = sweep.timeMs;
+}
+
+bool TMS::processAcquisition(uint32_t& readMs) {
+    bool read = false;
+    for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+        uint16_t reads = sensors[i]->readCount();
+        if (reads == acquisitionReads[i]) {
+            continue;
+        }
+        acquisitionReads[i] = reads;
+
+        uint32_t lastMs = sensors[i]->lastReadMs();
+        int16_t temp    = sensorTemps[i];
+        uint32_t period = lastMs - acquisitionLastMs[i];
+        if (temp != TMP117::ERROR_TEMP && acquisitionLastTemps[i] != TMP117::ERROR_TEMP && period > 0) {
+            int32_t change = static_cast<int32_t>(temp) - acquisitionLastTemps[i];
+            int32_t rate   = change * 1000 / static_cast<int32_t>(period);
+            // Rounded so the estimate settles on the rate instead of stopping short of it
+            int32_t diff     = rate - temperatureRates[i];
+            int32_t step     = (diff + (diff >= 0 ? RATE_SMOOTHING / 2 : -RATE_SMOOTHING / 2)) / RATE_SMOOTHING;
+            int32_t smoothed = temperatureRates[i] + step;
+            if (smoothed > INT16_MAX) {
+                smoothed = INT16_MAX;
+            } else if (smoothed < INT16_MIN) {
+                smoothed = INT16_MIN;
+            }
+
+            temperatureRates[i] = static_cast<int16_t>(smoothed);
+            pollPeriods[i]      = static_cast<uint16_t>(period < UINT16_MAX ? period : UINT16_MAX);
+        }
+        acquisitionLastMs[i]    = lastMs;
+        acquisitionLastTemps[i] = temp;
+
+        sensors[i]->setPollPeriod(pollPeriodForRate(temperatureRates[i]));
+
+        if (!read || static_cast<int32_t>(lastMs - readMs) > 0) {
+            readMs = lastMs;
+        }
+        read = true;
+    }
+    return read;
+}
+
+uint16_t TMS::pollPeriodForRate(int16_t rate) const {
+    // Limits written over SDO may cross, the longest period wins then
+    uint32_t maxPeriod = maxPollPeriod;
+    uint32_t minPeriod = minPollPeriod < maxPollPeriod ? minPollPeriod : maxPollPeriod;
+
+    uint32_t speed  = rate < 0 ? -static_cast<int32_t>(rate) : rate;
+    uint32_t period = speed > 0 ? static_cast<uint32_t>(pollStep) * 1000 / speed : maxPeriod;
+    if (period > maxPeriod) {
+        period = maxPeriod;
+    } else if (period < minPeriod) {
+        period = minPeriod;
+    }
+    return static_cast<uint16_t>(period);
+}
+
+void TMS::processCalibration() {
+    // Commands are written over SDO between calls, and read back as NONE once accepted
+    if (calibrationCommand != static_cast<uint8_t>(CalibrationCommand::NONE)) {
+        auto command       = static_cast<CalibrationCommand>(calibrationCommand);
+        calibrationCommand = static_cast<uint8_t>(CalibrationCommand::NONE);
+        startCalibration(command);
+    }
+
+    switch (static_cast<CalibrationState>(calibrationState)) {
+    case CalibrationState::MEASURING:
+        if (time::millis() - calibrationLastMs >= CALIBRATION_SAMPLE_PERIOD_MS) {
+            calibrationLastMs = time::millis();
+            sampleCalibration();
+        }
+        break;
+    case CalibrationState::APPLYING: {
+        bool pending = false;
+        bool failed  = false;
+        for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+            pending |= sensors[i]->calibrationStatus() == TMP117::CalibrationStatus::PENDING;
+            failed  |= sensors[i]->calibrationStatus() == TMP117::CalibrationStatus::FAILED;
+        }
+
+        if (!pending) {
+            setCalibrationState(failed || calibrationIncomplete ? CalibrationState::FAILED : CalibrationState::DONE);
+        } else if (time::millis() - calibrationLastMs >= CALIBRATION_APPLY_TIMEOUT_MS) {
+            // A sensor behind a failing mux bus is skipped and never gets to its request
+            setCalibrationState(CalibrationState::FAILED);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+
+    for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+        TMP117::CalibrationStatus status = sensors[i]->calibrationStatus();
+
+        // Pick up the offset the sensor holds each time it is read back, keeping offsets written over SDO until then
+        if (static_cast<uint8_t>(status) != calibrationStatus[i] && status != TMP117::CalibrationStatus::PENDING
+            && status != TMP117::CalibrationStatus::UNVERIFIED) {
+            calibrationOffsets[i] = sensors[i]->offset();
+        }
+        calibrationStatus[i] = static_cast<uint8_t>(status);
+    }
+}
+
+void TMS::startCalibration(CalibrationCommand command) {
+    calibrationIncomplete = false;
+    calibrationLastMs     = time::millis();
+
+    switch (command) {
+    case CalibrationCommand::APPLY:
+    case CalibrationCommand::APPLY_PERSIST:
+        for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+            sensors[i]->requestOffset(calibrationOffsets[i], command == CalibrationCommand::APPLY_PERSIST);
+        }
+        setCalibrationState(CalibrationState::APPLYING);
+        break;
+    case CalibrationCommand::CALIBRATE:
+    case CalibrationCommand::CALIBRATE_PERSIST:
+        if (calibrationReference >= NUM_TEMP_SENSORS || calibrationSamples == 0) {
+            setCalibrationState(CalibrationState::FAILED);
+            break;
+        }
+        calibrationPersist = command == CalibrationCommand::CALIBRATE_PERSIST;
+        calibrationTaken   = 0;
+        for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+            calibrationSums[i]   = 0;
+            calibrationCounts[i] = 0;
+        }
+        // The first sample is taken on this call, the next ones a conversion cycle apart
+        calibrationLastMs -= CALIBRATION_SAMPLE_PERIOD_MS;
+        setCalibrationState(CalibrationState::MEASURING);
+        break;
+    case CalibrationCommand::VERIFY:
+        for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+            sensors[i]->requestVerify();
+        }
+        setCalibrationState(CalibrationState::APPLYING);
+        break;
+    default:
+        log::LOGGER.log(log::Logger::LogLevel::ERROR, "Invalid calibration command %d", static_cast<int>(command));
+        setCalibrationState(CalibrationState::FAILED);
+    }
+}
+
+void TMS::sampleCalibration() {
+    int16_t reference = sensorTemps[calibrationReference];
+    if (reference != TMP117::ERROR_TEMP) {
+        for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+            if (i != calibrationReference && sensorTemps[i] != TMP117::ERROR_TEMP) {
+                calibrationSums[i] += reference - sensorTemps[i];
+                calibrationCounts[i]++;
+            }
+        }
+    }
+    if (++calibrationTaken < calibrationSamples) {
+        return;
+    }
+
+    // Each reading already includes the sensor's offset, so the mean difference is added to it
+    for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+        if (i == calibrationReference) {
+            continue;
+        }
+        if (calibrationCounts[i] == 0) {
+            calibrationIncomplete = true;
+            continue;
+        }
+
+        int32_t sum    = calibrationSums[i];
+        int32_t count  = calibrationCounts[i];
+        int32_t mean   = (sum + (sum >= 0 ? count / 2 : -count / 2)) / count;
+        int32_t offset = sensors[i]->offset() + mean;
+        if (offset > INT16_MAX) {
+            offset = INT16_MAX;
+        } else if (offset < INT16_MIN) {
+            offset = INT16_MIN;
+        }
+
+        calibrationOffsets[i] = static_cast<int16_t>(offset);
+        sensors[i]->requestOffset(calibrationOffsets[i], calibrationPersist);
+    }
+    calibrationLastMs = time::millis();
+    setCalibrationState(CalibrationState::APPLYING);
+}
+
+void TMS::setCalibrationState(CalibrationState state) {
+    calibrationState = static_cast<uint8_t>(state);
+}
+
+void TMS::canInterrupt(io::CANMessage& message, void* priv) {
+    auto* queue = (core::types::FixedQueue<CANOPEN_QUEUE_SIZE, io::CANMessage>*) priv;
+    if (queue != nullptr) {
+        queue->append(message);
+    }
+}
+
 } // namespace TMS
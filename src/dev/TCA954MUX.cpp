@@ -2,47 +2,97 @@
 
 namespace TMS {
 
-TCA954MUX::TCA954MUX(io::I2C& i2c, uint8_t addr, I2CDevice** buses[I2C_MUX_BUS_SIZE],
-                     uint8_t numDevices[I2C_MUX_BUS_SIZE])
-    : i2c(i2c), i2cSlaveAddress(addr), busDevices{buses[0], buses[1], buses[2], buses[3]}, numDevices{numDevices[0],
-                                                                                                      numDevices[1],
-                                                                                                      numDevices[2],
-                                                                                                      numDevices[3]} {};
+TCA954MUX::TCA954MUX(io::I2C& i2c, uint8_t addr, I2CDevice** buses[], uint8_t numDevices[], uint8_t numBuses)
+    : i2c(i2c), i2cSlaveAddress(addr),
+      numBuses(numBuses < I2C_MUX_MAX_BUS_SIZE ? numBuses : I2C_MUX_MAX_BUS_SIZE) {
+    for (uint8_t i = 0; i < this->numBuses; i++) {
+        busDevices[i]       = buses[i];
+        this->numDevices[i] = numDevices[i];
+    }
+}
 
 io::I2C::I2CStatus TCA954MUX::setBus(uint8_t bus, bool toggled) {
-    uint8_t val = static_cast<uint8_t>(toggled);
-    switch (bus) {
-    case 0:
-        return writeRegister(TCA954_BUS::BUS_0, val);
-    case 1:
-        return writeRegister(TCA954_BUS::BUS_1, val);
-    case 2:
-        return writeRegister(TCA954_BUS::BUS_2, val);
-    case 3:
-        return writeRegister(TCA954_BUS::BUS_3, val);
-    default:
+    if (bus >= numBuses) {
         return io::I2C::I2CStatus::ERROR;
     }
+
+    uint8_t mask = static_cast<uint8_t>(TCA954_BUS::BUS_0 << bus);
+    return writeControl(toggled ? mask : 0);
+}
+
+io::I2C::I2CStatus TCA954MUX::disableAll() {
+    if (control == 0) {
+        return io::I2C::I2CStatus::OK;
+    }
+    return writeControl(0);
 }
 
-io::I2C::I2CStatus TCA954MUX::writeRegister(uint8_t reg, uint8_t val) {
-    return i2c.write(i2cSlaveAddress, reg);
+io::I2C::I2CStatus TCA954MUX::writeControl(uint8_t val) {
+    io::I2C::I2CStatus status = i2c.write(i2cSlaveAddress, val);
+    if (status == io::I2C::I2CStatus::OK) {
+        control = val;
+    }
+    return status;
 }
 
-io::I2C::I2CStatus TCA954MUX::readRegister(uint8_t reg, uint8_t* val) {
-    return i2c.readReg(i2cSlaveAddress, reg, val);
+io::I2C::I2CStatus TCA954MUX::readControl(uint8_t* val) {
+    return i2c.read(i2cSlaveAddress, val);
 }
 
 void TCA954MUX::pollAllDevices() {
-    for (int i = 0; i < I2C_MUX_BUS_SIZE; i++) {
-        bool skip = false;
-        if (setBus(i, true) == io::I2C::I2CStatus::ERROR) {
-            skip = true;
+    poll(false);
+}
+
+io::I2C::I2CStatus TCA954MUX::action(bool skip) {
+    return poll(skip);
+}
+
+uint32_t TCA954MUX::value() {
+    return control;
+}
+
+bool TCA954MUX::due() {
+    for (uint8_t i = 0; i < numBuses; i++) {
+        if (busDue(i)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TCA954MUX::busDue(uint8_t bus) {
+    for (uint8_t j = 0; j < numDevices[bus]; j++) {
+        if (busDevices[bus][j]->due()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+io::I2C::I2CStatus TCA954MUX::poll(bool skip) {
+    io::I2C::I2CStatus status = skip ? io::I2C::I2CStatus::ERROR : io::I2C::I2CStatus::OK;
+
+    for (int i = 0; i < numBuses; i++) {
+        bool busSkip = skip;
+        if (!skip) {
+            // Selecting a bus costs a transfer, so buses with nothing to read are left alone
+            if (!busDue(i)) {
+                continue;
+            }
+            status = setBus(i, true);
+            if (status == io::I2C::I2CStatus::ERROR) {
+                busSkip = true;
+            }
         }
 
         for (int j = 0; j < numDevices[i]; j++) {
-            busDevices[i][j]->action(skip);
+            // Devices on a failed bus are all skipped, so none of them keeps a stale value
+            if (busSkip || busDevices[i][j]->due()) {
+                busDevices[i][j]->action(busSkip);
+            }
         }
     }
+
+    return status;
 }
 } // namespace TMS
@@ -1,6 +1,7 @@
 #include <cstdint>
 
 #include <core/io/I2C.hpp>
+#include <core/utils/time.hpp>
 #include <dev/TMP117.hpp>
 
 namespace TMS {
@@ -12,8 +13,9 @@ TMP117::TMP117() : i2c(nullptr) {}
 
 io::I2C::I2CStatus TMP117::readTemp(int16_t& temp) {
     uint8_t tempBytes[2];
+    uint8_t reg = TEMP_REG;
 
-    io::I2C::I2CStatus status = i2c->readReg(i2cSlaveAddress, (uint8_t*) TEMP_REG, 1, tempBytes, 2);
+    io::I2C::I2CStatus status = i2c->readReg(i2cSlaveAddress, &reg, 1, tempBytes, 2);
 
     if (status == io::I2C::I2CStatus::OK) {
         temp = static_cast<int16_t>(((uint16_t) tempBytes[0]) << 8 | tempBytes[1]);
@@ -21,22 +23,114 @@ io::I2C::I2CStatus TMP117::readTemp(int16_t& temp) {
         temp = INT16_MIN;
     }
 
+    temp = toCentiCelsius(temp);
+
+    return status;
+}
+
+int16_t TMP117::toCentiCelsius(int16_t raw) {
     /**
      * degrees centi celsius
      * multiplied by 78125 because the sensor output increases by .0078125 degrees celsius - brings it to fixed point
      * within 32 bits divided by 100000 so it fits in a 16 bit int
      */
-    temp = ((int64_t) temp) * 78125 / 100000;
+    return static_cast<int16_t>(((int64_t) raw) * 78125 / 100000);
+}
 
-    return status;
+int16_t TMP117::fromCentiCelsius(int16_t centiCelsius) {
+    // One LSB is 0.78125 centi-celsius, so raw = centi-celsius * 32 / 25, rounded to nearest
+    int32_t scaled = static_cast<int32_t>(centiCelsius) * 32;
+    int32_t raw    = (scaled + (scaled >= 0 ? 12 : -12)) / 25;
+
+    if (raw > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (raw < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return static_cast<int16_t>(raw);
+}
+
+void TMP117::requestOffset(int16_t centiCelsius, bool persist) {
+    pendingOffset  = centiCelsius;
+    pendingPersist = persist;
+    pending        = true;
+    calibration    = CalibrationStatus::PENDING;
+}
+
+void TMP117::requestVerify() {
+    verified    = false;
+    calibration = CalibrationStatus::PENDING;
+}
+
+int16_t TMP117::offset() const {
+    return offsetValue;
+}
+
+TMP117::CalibrationStatus TMP117::calibrationStatus() const {
+    return calibration;
+}
+
+void TMP117::setPollPeriod(uint16_t periodMs) {
+    pollPeriodMs     = periodMs;
+    conversionConfig = static_cast<uint16_t>((config & ~CONVERSION_MASK) | conversionBits(periodMs));
+}
+
+uint32_t TMP117::lastReadMs() const {
+    return lastPollMs;
+}
+
+uint16_t TMP117::readCount() const {
+    return reads;
+}
+
+bool TMP117::due() {
+    return pending || !verified || eepromStep != EEPROMStep::IDLE
+           || core::time::millis() - lastPollMs >= pollPeriodMs;
+}
+
+uint16_t TMP117::conversionBits(uint16_t periodMs) {
+    // Average as much as possible while still finishing a conversion between reads, so no read repeats the last one
+    if (periodMs >= 1000) {
+        return CONVERSION_AVG_64;
+    }
+    if (periodMs >= 500) {
+        return CONVERSION_AVG_32;
+    }
+    if (periodMs >= 125) {
+        return CONVERSION_AVG_8;
+    }
+    return CONVERSION_FAST;
 }
 
 io::I2C::I2CStatus TMP117::action(bool skip = false) {
     io::I2C::I2CStatus status = io::I2C::I2CStatus::ERROR;
     if (skip) {
         lastTempValue = ERROR_TEMP;
+    } else if (eepromStep != EEPROMStep::IDLE) {
+        // Reads are held off while programming, so the time it takes does not show up in the rate of change
+        continueEEPROM();
+        status = io::I2C::I2CStatus::OK;
     } else {
-        status = readTemp(lastTempValue);
+        // The sensor is only reachable while its mux bus is selected, so calibration is done here
+        if (pending) {
+            pending = false;
+            applyOffset();
+        } else if (!verified) {
+            verified = verify();
+        }
+
+        // Writes to the configuration with the EEPROM locked only change the register, so this causes no wear
+        if (eepromStep == EEPROMStep::IDLE && conversionConfig != activeConfig) {
+            configWritten = true;
+            if (writeRegister(CONFIG_REG, conversionConfig) == io::I2C::I2CStatus::OK) {
+                activeConfig = conversionConfig;
+            }
+        }
+
+        status     = readTemp(lastTempValue);
+        lastPollMs = core::time::millis();
+        reads++;
     }
 
     if (tempPtr) {
@@ -50,4 +144,117 @@ uint32_t TMP117::value() {
     return lastTempValue;
 }
 
+bool TMP117::verify() {
+    uint16_t offsetRaw;
+    uint16_t configValue;
+    if (readRegister(TEMP_OFFSET_REG, offsetRaw) != io::I2C::I2CStatus::OK
+        || readRegister(CONFIG_REG, configValue) != io::I2C::I2CStatus::OK) {
+        calibration = CalibrationStatus::FAILED;
+        return false;
+    }
+
+    offsetValue = toCentiCelsius(static_cast<int16_t>(offsetRaw));
+    if (!configWritten) {
+        // Still the configuration loaded from EEPROM at power up
+        configStored = (configValue & SETTINGS_MASK) == (config & SETTINGS_MASK);
+    }
+    calibration = (configValue & CONVERSION_MASK) == (activeConfig & CONVERSION_MASK) ? CalibrationStatus::VERIFIED
+                                                                                      : CalibrationStatus::FAILED;
+    // A configuration that does not match is rewritten by the same action
+    activeConfig = configValue;
+    return true;
+}
+
+void TMP117::applyOffset() {
+    uint16_t raw = static_cast<uint16_t>(fromCentiCelsius(pendingOffset));
+
+    if (pendingPersist) {
+        // While unlocked, every register write also programs the EEPROM and has to finish before the next one
+        eepromOffset = raw;
+        if (writeRegister(EEPROM_UL_REG, EEPROM_UNLOCK) != io::I2C::I2CStatus::OK) {
+            finishEEPROM(false);
+        } else if (configStored) {
+            programEEPROM(TEMP_OFFSET_REG, raw, EEPROMStep::OFFSET);
+        } else {
+            configWritten = true;
+            if (programEEPROM(CONFIG_REG, config, EEPROMStep::CONFIG)) {
+                activeConfig = config;
+            }
+        }
+        return;
+    }
+
+    bool written = writeRegister(TEMP_OFFSET_REG, raw) == io::I2C::I2CStatus::OK;
+    verified     = readBackOffset(raw, written, CalibrationStatus::APPLIED);
+}
+
+void TMP117::continueEEPROM() {
+    uint16_t unlock;
+    if (readRegister(EEPROM_UL_REG, unlock) != io::I2C::I2CStatus::OK) {
+        finishEEPROM(false);
+        return;
+    }
+    if (unlock & EEPROM_BUSY) {
+        if (core::time::millis() - eepromStartMs > EEPROM_TIMEOUT_MS) {
+            finishEEPROM(false);
+        }
+        return;
+    }
+
+    if (eepromStep == EEPROMStep::CONFIG) {
+        programEEPROM(TEMP_OFFSET_REG, eepromOffset, EEPROMStep::OFFSET);
+        return;
+    }
+    finishEEPROM(true);
+}
+
+bool TMP117::programEEPROM(uint8_t reg, uint16_t value, EEPROMStep step) {
+    if (writeRegister(reg, value) != io::I2C::I2CStatus::OK) {
+        finishEEPROM(false);
+        return false;
+    }
+    eepromStep    = step;
+    eepromStartMs = core::time::millis();
+    return true;
+}
+
+void TMP117::finishEEPROM(bool programmed) {
+    eepromStep = EEPROMStep::IDLE;
+    if (programmed) {
+        configStored = true;
+    }
+
+    // Lock even after a failure, so later register writes do not wear the EEPROM
+    bool locked = writeRegister(EEPROM_UL_REG, 0) == io::I2C::I2CStatus::OK;
+    verified    = readBackOffset(eepromOffset, programmed && locked, CalibrationStatus::PERSISTED);
+}
+
+bool TMP117::readBackOffset(uint16_t raw, bool written, CalibrationStatus success) {
+    uint16_t readBack = 0;
+    bool read         = readRegister(TEMP_OFFSET_REG, readBack) == io::I2C::I2CStatus::OK;
+    if (read) {
+        offsetValue = toCentiCelsius(static_cast<int16_t>(readBack));
+    }
+
+    // A request made meanwhile keeps the state pending until it is applied
+    if (!pending) {
+        calibration = written && read && readBack == raw ? success : CalibrationStatus::FAILED;
+    }
+    return read;
+}
+
+io::I2C::I2CStatus TMP117::writeRegister(uint8_t reg, uint16_t value) {
+    uint8_t bytes[2] = {static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value)};
+    return i2c->writeReg(i2cSlaveAddress, &reg, 1, bytes, 2);
+}
+
+io::I2C::I2CStatus TMP117::readRegister(uint8_t reg, uint16_t& value) {
+    uint8_t bytes[2];
+    io::I2C::I2CStatus status = i2c->readReg(i2cSlaveAddress, &reg, 1, bytes, 2);
+    if (status == io::I2C::I2CStatus::OK) {
+        value = static_cast<uint16_t>(bytes[0] << 8 | bytes[1]);
+    }
+    return status;
+}
+
 } // namespace TMS
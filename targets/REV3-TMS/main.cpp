@@ -23,26 +23,6 @@ namespace log  = core::log;
 
 #define NUM_TEMP_SENSORS 5
 
-///////////////////////////////////////////////////////////////////////////////
-// EVT-core CAN callback and CAN setup. This will include logic to set
-// aside CANopen messages into a specific queue
-///////////////////////////////////////////////////////////////////////////////
-
-/**
- * Interrupt handler to get CAN messages. A function pointer to this function
- * will be passed to the EVT-core CAN interface which will in turn call this
- * function each time a new CAN message comes in.
- *
- * @param message[in] The passed in CAN message that was read.
- * @param priv[in] The private data (FixedQueue<CANOPEN_QUEUE_SIZE, CANMessage>)
- */
-void canInterrupt(io::CANMessage& message, void* priv) {
-    auto* queue = (core::types::FixedQueue<CANOPEN_QUEUE_SIZE, io::CANMessage>*) priv;
-    if (queue != nullptr) {
-        queue->append(message);
-    }
-}
-
 TMS::TMS* tmsPtr = nullptr;
 // Keep the TMS instance up-to-date with the NMT mode
 extern "C" void CONmtModeChange(CO_NMT* nmt, CO_MODE mode) {
@@ -96,13 +76,24 @@ int main() {
     devices[4] = TMS::TMP117(&i2c, 0x4A, &sensorTemps[4]);
     bus1[1]    = &devices[4];
 
+    // Sensor drivers in sensorTemps order, for calibration
+    TMS::TMP117* sensors[NUM_TEMP_SENSORS];
+    for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+        sensors[i] = &devices[i];
+    }
+
     TMS::TCA954MUX tca(i2c, 0x70, buses, numDevices);
 
+    // Muxes on the main I2C bus. Additional TCA954x parts at other addresses can be listed here, or cascaded by adding
+    // them to a bus of another mux.
+    TMS::TCA954MUX* muxes[1] = {&tca};
+    static_assert(sizeof(muxes) / sizeof(muxes[0]) <= TMS::TMS::MAX_MUXES, "TMS polls at most MAX_MUXES muxes");
+
     // Setup all the pumps
     TMS::Pump pumps[2] = {TMS::Pump(io::getPWM<TMS::TMS::PUMP1_PWM>()), TMS::Pump(io::getPWM<TMS::TMS::PUMP2_PWM>())};
 
     // Setup main TMS instance with configured MUX and pumps
-    TMS::TMS tms(sensorTemps, tca, pumps);
+    TMS::TMS tms(sensorTemps, sensors, muxes, 1, pumps);
     tmsPtr = &tms;
 
     ///////////////////////////////////////////////////////////////////////////
@@ -119,7 +110,7 @@ int main() {
 
     // Initialize CAN, add an IRQ that will populate the above queue
     io::CAN& can = io::getCAN<TMS::TMS::CAN_TX, TMS::TMS::CAN_RX>();
-    can.addIRQHandler(canInterrupt, reinterpret_cast<void*>(&canOpenQueue));
+    can.addIRQHandler(TMS::TMS::canInterrupt, reinterpret_cast<void*>(&canOpenQueue));
 
     // Reserved memory for CANopen stack usage
     uint8_t sdoBuffer[CO_SSDO_N * CO_SDO_BUF_BYTE];
@@ -158,6 +149,7 @@ int main() {
     ///////////////////////////////////////////////////////////////////////////
     while (1) {
         tms.process();
+        tms.updatePDOTemps();
         io::processCANopenNode(&canNode);
         time::wait(1);
     }
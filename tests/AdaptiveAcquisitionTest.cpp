@@ -0,0 +1,172 @@
+/**
+ * Checks the adaptive acquisition on the simulated node: the conversion configuration each poll period selects, and
+ * the poll period and rate of change the board settles on for steady and ramping sensors, with the limits at 0x2500
+ * written over SDO. Exits non-zero if any check fails.
+ */
+
+#include <cstdio>
+
+#include <core/utils/time.hpp>
+
+#include "SdoClient.hpp"
+
+namespace time = core::time;
+
+namespace {
+
+/** Sensor the temperature ramps are applied to */
+constexpr uint8_t RAMP_SENSOR = 1;
+
+/** Time a read may come after it is due: the rest of the main loop iteration and the I2C time of the sweep */
+constexpr uint32_t LATE_MS = 20;
+
+/** Configuration bits for the conversion mode, cycle time and averaging */
+constexpr uint16_t CONVERSION_MASK = 0x0FE0;
+
+int failures = 0;
+
+/**
+ * Check a condition, reporting it if it does not hold
+ *
+ * @param[in] condition Whether the check passed
+ * @param[in] what Description of the check
+ */
+void check(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+/**
+ * Check that a value is within a range, reporting it if it is not
+ *
+ * @param[in] value Value to check
+ * @param[in] low Lowest value allowed
+ * @param[in] high Highest value allowed
+ * @param[in] what Description of the check
+ */
+void checkRange(int32_t value, int32_t low, int32_t high, const char* what) {
+    if (value < low || value > high) {
+        std::fprintf(stderr, "FAIL: %s, %d not in [%d, %d]\n", what, static_cast<int>(value), static_cast<int>(low),
+                     static_cast<int>(high));
+        failures++;
+    }
+}
+
+/**
+ * Run the main loop while the ramp sensor moves at a fixed rate
+ *
+ * @param[in] node Node to run
+ * @param[in,out] celsius Temperature of the ramp sensor, updated to where the ramp ends
+ * @param[in] ratePerS Rate in degrees celsius per second
+ * @param[in] durationMs Time to run for
+ */
+void ramp(cansim::TMSNode& node, double& celsius, double ratePerS, uint32_t durationMs) {
+    uint32_t start = time::millis();
+    uint32_t last  = start;
+    while (time::millis() - start < durationMs) {
+        celsius += ratePerS * (time::millis() - last) / 1000;
+        last = time::millis();
+        node.board.simSensors[RAMP_SENSOR].setTemperature(celsius);
+        node.step();
+    }
+}
+
+/**
+ * Read the measured poll period and rate of change of the ramp sensor over SDO and check them
+ *
+ * @param[in] sdo Client to read with
+ * @param[in] periodMs Poll period the sensor should settle on
+ * @param[in] rate Rate of change in centi-celsius per second, within 5 %
+ * @param[in] what Description of the case
+ */
+void expectRampSensor(test::SdoClient& sdo, uint16_t periodMs, int16_t rate, const char* what) {
+    uint32_t period   = 0;
+    uint32_t rawRate  = 0;
+    int32_t tolerance = (rate < 0 ? -rate : rate) / 20 + 1;
+    check(sdo.upload(0x2501, RAMP_SENSOR + 1, period) && sdo.upload(0x2502, RAMP_SENSOR + 1, rawRate), what);
+    checkRange(static_cast<int32_t>(period), periodMs, periodMs + LATE_MS, what);
+    checkRange(static_cast<int16_t>(rawRate), rate - tolerance, rate + tolerance, what);
+}
+
+/**
+ * Check that every poll period selects the expected conversions, reading the configuration of the simulated sensors
+ */
+void checkConversions() {
+    struct Case {
+        uint16_t periodMs;
+        uint16_t conversion;
+    };
+    // No averaging with a 15.5 ms cycle, then 8 averages in 125 ms, 32 in 500 ms and 64 in 1 s
+    const Case cases[] = {
+        {1, 0x0000},    {124, 0x0000},  {125, 0x0020},  {499, 0x0020},
+        {500, 0x0040},  {999, 0x0040},  {1000, 0x0060}, {2000, 0x0060},
+    };
+
+    // Without TMS::process() nothing changes the poll periods set here
+    sim::SimBoard board;
+    for (const Case& test : cases) {
+        for (TMS::TMP117& sensor : board.sensors) {
+            sensor.setPollPeriod(test.periodMs);
+        }
+        time::wait(test.periodMs);
+        board.mux.pollAllDevices();
+        for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+            uint16_t conversion = board.simSensors[i].reg(sim::SimTMP117::CONFIGURATION) & CONVERSION_MASK;
+            if (conversion != test.conversion) {
+                std::fprintf(stderr, "FAIL: poll period %u ms gave conversion bits 0x%04X, expected 0x%04X\n",
+                             test.periodMs, conversion, test.conversion);
+                failures++;
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    sim::SimClock::reset();
+    checkConversions();
+
+    cansim::Bus bus(500000);
+    cansim::TMSNode node(bus, 1, false);
+    test::SdoClient sdo(bus, node);
+    double celsius = 31.0;
+
+    // Steady sensors are read at the maximum period, 1000 ms by default
+    ramp(node, celsius, 0, 3000);
+    expectRampSensor(sdo, 1000, 0, "steady sensor at the maximum period");
+    for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+        uint32_t period = 0;
+        check(sdo.upload(0x2501, i + 1, period) && period >= 1000 && period <= 1000 + LATE_MS, "every sensor steady");
+    }
+    check((node.board.simSensors[RAMP_SENSOR].reg(sim::SimTMP117::CONFIGURATION) & CONVERSION_MASK) == 0x0060,
+          "64 averages at 1000 ms");
+
+    // With 0.4 degrees allowed between reads, 1 degree per second is read every 400 ms
+    check(sdo.download(0x2500, 3, 2, 40), "step written");
+    ramp(node, celsius, 1.0, 12000);
+    expectRampSensor(sdo, 400, 100, "period follows the rate");
+    check((node.board.simSensors[RAMP_SENSOR].reg(sim::SimTMP117::CONFIGURATION) & CONVERSION_MASK) == 0x0020,
+          "8 averages at 400 ms");
+
+    // 10 degrees per second would be read every 40 ms, the minimum period holds it at 50 ms
+    check(sdo.download(0x2500, 1, 2, 50), "minimum written");
+    ramp(node, celsius, 10.0, 3000);
+    expectRampSensor(sdo, 50, 1000, "fast sensor at the minimum period");
+    check((node.board.simSensors[RAMP_SENSOR].reg(sim::SimTMP117::CONFIGURATION) & CONVERSION_MASK) == 0x0000,
+          "no averaging at 50 ms");
+
+    // A minimum above the maximum gives way to the maximum
+    check(sdo.download(0x2500, 1, 2, 1200), "crossing minimum written");
+    ramp(node, celsius, 10.0, 4000);
+    expectRampSensor(sdo, 1000, 1000, "crossed limits hold the maximum");
+
+    if (failures) {
+        std::fprintf(stderr, "%d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("All checks passed\n");
+    return 0;
+}
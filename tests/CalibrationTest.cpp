@@ -0,0 +1,170 @@
+/**
+ * Checks the calibration commands at 0x2400 on the simulated node: offsets written to 0x2401 and applied reach the
+ * sensors, a calibration against the reference sensor makes every reading agree and programs the offsets into EEPROM
+ * when asked to, and invalid commands fail. Exits non-zero if any check fails.
+ */
+
+#include <cstdio>
+
+#include <core/utils/time.hpp>
+
+#include "SdoClient.hpp"
+
+namespace time = core::time;
+
+namespace {
+
+/** Values of 0x2400 sub 4, TMS::CalibrationState */
+constexpr uint32_t STATE_IDLE      = 0;
+constexpr uint32_t STATE_MEASURING = 1;
+constexpr uint32_t STATE_APPLYING  = 2;
+constexpr uint32_t STATE_DONE      = 3;
+constexpr uint32_t STATE_FAILED    = 4;
+
+/** Values of 0x2402, TMP117::CalibrationStatus */
+constexpr uint32_t STATUS_VERIFIED  = 1;
+constexpr uint32_t STATUS_APPLIED   = 3;
+constexpr uint32_t STATUS_PERSISTED = 4;
+
+/** Time a command is given to finish, enough for every sample of a calibration */
+constexpr uint32_t COMMAND_TIMEOUT_MS = 10000;
+
+int failures = 0;
+
+/**
+ * Check a condition, reporting it if it does not hold
+ *
+ * @param[in] condition Whether the check passed
+ * @param[in] what Description of the check
+ */
+void check(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+/**
+ * Whether two temperatures agree within the resolution of the sensors
+ *
+ * @param[in] centiCelsius Temperature to compare
+ * @param[in] expected Temperature it should agree with
+ */
+bool within(int32_t centiCelsius, int32_t expected) {
+    return centiCelsius >= expected - 1 && centiCelsius <= expected + 1;
+}
+
+/**
+ * Write a calibration command and run the node until it is no longer measuring or applying
+ *
+ * @param[in] sdo Client to write with
+ * @param[in] command Command written to 0x2400 sub 1
+ * @return The state at 0x2400 sub 4 the command ended in
+ */
+uint32_t runCommand(test::SdoClient& sdo, uint8_t command) {
+    uint32_t state = STATE_IDLE;
+    check(sdo.download(0x2400, 1, 1, command), "command written");
+
+    uint32_t accepted = command;
+    check(sdo.upload(0x2400, 1, accepted) && accepted == 0, "command read back as accepted");
+
+    uint32_t start = time::millis();
+    while (sdo.upload(0x2400, 4, state) && (state == STATE_MEASURING || state == STATE_APPLYING)
+           && time::millis() - start < COMMAND_TIMEOUT_MS) {}
+    return state;
+}
+
+/**
+ * Check that every sensor reports a calibration status at 0x2402
+ *
+ * @param[in] sdo Client to read with
+ * @param[in] status Status every sensor should report
+ * @param[in] what Description of the check
+ */
+void expectStatus(test::SdoClient& sdo, uint32_t status, const char* what) {
+    for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+        uint32_t value = 0;
+        check(sdo.upload(0x2402, i + 1, value) && value == status, what);
+    }
+}
+
+} // namespace
+
+int main() {
+    sim::SimClock::reset();
+    cansim::Bus bus(500000);
+    cansim::TMSNode node(bus, 1, false);
+    test::SdoClient sdo(bus, node);
+    sim::SimBoard& board = node.board;
+
+    // Every sensor is read back on its first read after boot
+    uint32_t state = STATE_FAILED;
+    check(sdo.upload(0x2400, 4, state) && state == STATE_IDLE, "idle after boot");
+    expectStatus(sdo, STATUS_VERIFIED, "verified after boot");
+
+    // Offsets written over SDO reach the sensors, rounded to their resolution
+    const int16_t offsets[NUM_TEMP_SENSORS] = {0, 150, -250, 333, -1};
+    for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+        check(sdo.download(0x2401, i + 1, 2, static_cast<uint16_t>(offsets[i])), "offset written");
+    }
+    check(runCommand(sdo, 1) == STATE_DONE, "offsets applied");
+    expectStatus(sdo, STATUS_APPLIED, "applied without EEPROM");
+    for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+        int16_t raw    = TMS::TMP117::fromCentiCelsius(offsets[i]);
+        uint32_t value = 0;
+        check(sdo.upload(0x2401, i + 1, value)
+                  && static_cast<int16_t>(value) == TMS::TMP117::toCentiCelsius(raw),
+              "offset read back from the sensor");
+        check(static_cast<int16_t>(board.simSensors[i].reg(sim::SimTMP117::TEMP_OFFSET)) == raw,
+              "offset in the sensor register");
+        check(board.simSensors[i].eeprom(sim::SimTMP117::TEMP_OFFSET) == 0, "offset not programmed");
+    }
+
+    // Calibrating against sensor 0 makes every reading agree with it, each sensor 1 degree apart to start with
+    check(sdo.download(0x2400, 2, 1, 0) && sdo.download(0x2400, 3, 1, 2), "reference and samples written");
+    check(runCommand(sdo, 4) == STATE_DONE, "calibration done");
+    uint32_t referenceStatus = 0;
+    check(sdo.upload(0x2402, 1, referenceStatus) && referenceStatus == STATUS_APPLIED, "reference sensor left alone");
+    for (uint8_t i = 1; i < NUM_TEMP_SENSORS; i++) {
+        uint32_t status = 0;
+        uint32_t value  = 0;
+        check(sdo.upload(0x2402, i + 1, status) && status == STATUS_PERSISTED, "calibration persisted");
+        check(sdo.upload(0x2401, i + 1, value) && within(static_cast<int16_t>(value), -100 * i), "calibrated offset");
+        check(board.simSensors[i].eeprom(sim::SimTMP117::TEMP_OFFSET)
+                  == board.simSensors[i].reg(sim::SimTMP117::TEMP_OFFSET),
+              "calibrated offset programmed");
+    }
+
+    // Wait for every sensor to be read with its new offset
+    uint32_t start = time::millis();
+    while (time::millis() - start < 1500) {
+        node.step();
+    }
+    uint32_t reference = 0;
+    check(sdo.upload(0x2101, 1, reference), "reference read");
+    for (uint8_t i = 1; i < NUM_TEMP_SENSORS; i++) {
+        uint32_t value = 0;
+        check(sdo.upload(0x2101, i + 1, value)
+                  && within(static_cast<int16_t>(value), static_cast<int16_t>(reference)),
+              "reading agrees with the reference");
+    }
+
+    // Reading the calibration back leaves it in place
+    check(runCommand(sdo, 5) == STATE_DONE, "verify done");
+    expectStatus(sdo, STATUS_VERIFIED, "verified");
+
+    // Commands that cannot run fail without touching the sensors
+    check(sdo.download(0x2400, 2, 1, NUM_TEMP_SENSORS), "invalid reference written");
+    check(runCommand(sdo, 3) == STATE_FAILED, "invalid reference fails");
+    check(sdo.download(0x2400, 2, 1, 0) && sdo.download(0x2400, 3, 1, 0), "no samples written");
+    check(runCommand(sdo, 3) == STATE_FAILED, "no samples fails");
+    check(runCommand(sdo, 9) == STATE_FAILED, "unknown command fails");
+    expectStatus(sdo, STATUS_VERIFIED, "still verified");
+
+    if (failures) {
+        std::fprintf(stderr, "%d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("All checks passed\n");
+    return 0;
+}
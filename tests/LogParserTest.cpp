@@ -0,0 +1,76 @@
+/**
+ * Checks the candump log parser against lines at the edges of the format. Exits non-zero if any check fails.
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include <LogParser.hpp>
+
+using tmsdecode::LogFrame;
+using tmsdecode::LogParser;
+
+namespace {
+
+int failures = 0;
+
+/**
+ * Parse a single line and check what it held
+ *
+ * @param[in] line The log line, without a newline
+ * @param[in] expected What the line should hold
+ * @param[out] frame The frame on the line
+ */
+void expect(const char* line, LogParser::Result expected, LogFrame& frame) {
+    LogParser parser(line, line + std::strlen(line));
+    LogParser::Result result = parser.next(frame);
+    if (result != expected) {
+        std::fprintf(stderr, "FAIL: \"%s\" gave result %d, expected %d\n", line, static_cast<int>(result),
+                     static_cast<int>(expected));
+        failures++;
+    }
+}
+
+/**
+ * Check a condition, reporting the line it was about if it does not hold
+ *
+ * @param[in] condition Whether the check passed
+ * @param[in] line The log line being checked
+ * @param[in] what Description of the check
+ */
+void check(bool condition, const char* line, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: \"%s\": %s\n", line, what);
+        failures++;
+    }
+}
+
+} // namespace
+
+int main() {
+    LogFrame frame;
+
+    const char* highest = "(1436509052.249713) can0 7FF#0A0B";
+    expect(highest, LogParser::Result::FRAME, frame);
+    check(frame.id == 0x7FF && !frame.extended, highest, "identifier 0x7FF standard");
+    check(frame.timeUs == 1436509052249713, highest, "time in microseconds");
+    check(frame.dlc == 2 && frame.data[0] == 0x0A && frame.data[1] == 0x0B, highest, "two data bytes");
+
+    const char* extended = "(1436509052.249713) can0 1FFFFFFF#";
+    expect(extended, LogParser::Result::FRAME, frame);
+    check(frame.id == 0x1FFFFFFF && frame.extended && frame.dlc == 0, extended, "empty extended frame");
+
+    // Three hex digits hold identifiers that do not fit in 11 bits
+    expect("(1436509052.249713) can0 800#00", LogParser::Result::MALFORMED, frame);
+    expect("(1436509052.249713) can0 FFF#0102030405060708", LogParser::Result::MALFORMED, frame);
+
+    expect("(1436509052.249713) can0 12#00", LogParser::Result::MALFORMED, frame);
+    expect("(1436509052.249713) can0 282#R", LogParser::Result::SKIPPED, frame);
+
+    if (failures) {
+        std::fprintf(stderr, "%d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,124 @@
+#ifndef TMS_TESTS_SDOCLIENT_HPP
+#define TMS_TESTS_SDOCLIENT_HPP
+
+#include <cstdint>
+
+#include <Bus.hpp>
+#include <Node.hpp>
+#include <sim/SimClock.hpp>
+
+namespace test {
+
+/**
+ * Expedited SDO transfers to the TMS on the simulated bus of tms-can-sim. Each transfer runs the main loop of the node
+ * until it answers, as a client on the bus would wait for it.
+ */
+class SdoClient {
+public:
+    /** Sender identifier of the client on the bus */
+    static constexpr uint8_t SENDER = 1;
+
+    /** Main loop iterations to wait for an answer */
+    static constexpr uint32_t TIMEOUT_LOOPS = 100;
+
+    /**
+     * Become the receiver of the bus, passing every frame on to the node
+     *
+     * @param[in] bus Bus the node is on
+     * @param[in] node Node to talk to
+     */
+    SdoClient(cansim::Bus& bus, cansim::TMSNode& node) : bus(bus), node(node) {
+        nodeId = node.board.tms.getNodeID();
+        bus.setReceiver([this](const cansim::Frame& frame, uint8_t sender, uint64_t doneUs) {
+            this->node.onFrame(frame, sender, doneUs);
+            if (sender == cansim::TMSNode::SENDER && frame.id == 0x580u + nodeId) {
+                response = frame;
+                answered = true;
+            }
+        });
+    }
+
+    SdoClient(const SdoClient&) = delete;
+
+    SdoClient& operator=(const SdoClient&) = delete;
+
+    /**
+     * Read an object
+     *
+     * @param[in] index Object index
+     * @param[in] subIndex Object sub-index
+     * @param[out] value Value read, zero extended
+     * @return Whether the node answered with the value
+     */
+    bool upload(uint16_t index, uint8_t subIndex, uint32_t& value) {
+        if (!request(0x40, index, subIndex, 0) || (response.data[0] & 0xE3) != 0x43) {
+            return false;
+        }
+        uint8_t size = 4 - ((response.data[0] >> 2) & 0x03);
+        value        = 0;
+        for (uint8_t i = 0; i < size; i++) {
+            value |= static_cast<uint32_t>(response.data[4 + i]) << (8 * i);
+        }
+        return true;
+    }
+
+    /**
+     * Write an object
+     *
+     * @param[in] index Object index
+     * @param[in] subIndex Object sub-index
+     * @param[in] size Size of the object in bytes, 1 to 4
+     * @param[in] value Value to write
+     * @return Whether the node confirmed the write
+     */
+    bool download(uint16_t index, uint8_t subIndex, uint8_t size, uint32_t value) {
+        auto command = static_cast<uint8_t>(0x23 | (4 - size) << 2);
+        return request(command, index, subIndex, value) && response.data[0] == 0x60;
+    }
+
+private:
+    /** Bus the node is on */
+    cansim::Bus& bus;
+    /** Node talked to */
+    cansim::TMSNode& node;
+    /** Node ID of the TMS */
+    uint8_t nodeId;
+    /** Last SDO response of the node */
+    cansim::Frame response;
+    /** Whether the node answered the current request */
+    bool answered = false;
+
+    /**
+     * Send a request and run the node until it answers
+     *
+     * @param[in] command Command byte
+     * @param[in] index Object index
+     * @param[in] subIndex Object sub-index
+     * @param[in] value Data bytes, little-endian
+     * @return Whether the node answered
+     */
+    bool request(uint8_t command, uint16_t index, uint8_t subIndex, uint32_t value) {
+        cansim::Frame frame;
+        frame.timeUs  = sim::SimClock::micros();
+        frame.id      = 0x600u + nodeId;
+        frame.dlc     = 8;
+        frame.data[0] = command;
+        frame.data[1] = static_cast<uint8_t>(index);
+        frame.data[2] = static_cast<uint8_t>(index >> 8);
+        frame.data[3] = subIndex;
+        for (uint8_t i = 0; i < 4; i++) {
+            frame.data[4 + i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+
+        answered = false;
+        bus.transmit(frame, SENDER);
+        for (uint32_t i = 0; i < TIMEOUT_LOOPS && !answered; i++) {
+            node.step();
+        }
+        return answered;
+    }
+};
+
+} // namespace test
+
+#endif // TMS_TESTS_SDOCLIENT_HPP
@@ -0,0 +1,127 @@
+/**
+ * Checks the sweep publication on the simulated node: 0x2600 counts the sweeps that read a sensor rather than main loop
+ * iterations and carries the time of the latest read, and the TPDO objects only change when updatePDOTemps() takes a
+ * new sweep. Exits non-zero if any check fails.
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include "SdoClient.hpp"
+
+namespace {
+
+int failures = 0;
+
+/**
+ * Check a condition, reporting it if it does not hold
+ *
+ * @param[in] condition Whether the check passed
+ * @param[in] what Description of the check
+ */
+void check(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+/**
+ * Read an object straight from the dictionary, without running the main loop as an SDO transfer does
+ *
+ * @param[in] tms Board to read
+ * @param[in] index Object index
+ * @param[in] subIndex Object sub-index
+ * @param[in] size Size of the object in bytes
+ * @return The value, zero extended
+ */
+uint32_t readObject(TMS::TMS& tms, uint16_t index, uint8_t subIndex, uint8_t size) {
+    CO_NODE node = {};
+    CO_DICT dictionary;
+    dictionary.Node  = &node;
+    dictionary.Root  = tms.getObjectDictionary();
+    dictionary.Num   = tms.getNumElements();
+    CO_OBJ_T* object = CODictFind(&dictionary, CO_DEV(index, subIndex));
+
+    uint32_t value = 0;
+    if (object) {
+        std::memcpy(&value, reinterpret_cast<void*>(object->Data), size);
+    }
+    return value;
+}
+
+/** Number of reads of every sensor since boot */
+uint32_t totalReads(sim::SimBoard& board) {
+    uint32_t reads = 0;
+    for (TMS::TMP117& sensor : board.sensors) {
+        reads += sensor.readCount();
+    }
+    return reads;
+}
+
+/** Time of the latest read of any sensor */
+uint32_t latestReadMs(sim::SimBoard& board) {
+    uint32_t latest = 0;
+    for (TMS::TMP117& sensor : board.sensors) {
+        latest = sensor.lastReadMs() > latest ? sensor.lastReadMs() : latest;
+    }
+    return latest;
+}
+
+} // namespace
+
+int main() {
+    sim::SimClock::reset();
+    cansim::Bus bus(500000);
+    cansim::TMSNode node(bus, 1, false);
+    test::SdoClient sdo(bus, node);
+    sim::SimBoard& board = node.board;
+
+    check(readObject(board.tms, 0x2600, 1, 4) == 0, "nothing published before the first sweep");
+
+    // The first iteration reads every sensor to verify it
+    uint32_t sequence = 0;
+    uint32_t sweepMs  = 0;
+    check(sdo.upload(0x2600, 1, sequence) && sequence == 1, "first sweep published");
+    check(sdo.upload(0x2600, 2, sweepMs) && sweepMs == latestReadMs(board), "sweep stamped with its latest read");
+
+    // The sensors then wait for their poll period, and iterations that read nothing publish nothing
+    uint32_t start        = readObject(board.tms, 0x2600, 1, 4);
+    uint32_t readingLoops = 0;
+    for (uint32_t loop = 0; loop < 3000; loop++) {
+        uint32_t reads = totalReads(board);
+        node.step();
+        readingLoops += totalReads(board) != reads;
+    }
+    check(readingLoops > 0 && readingLoops < 100, "most iterations read no sensor");
+    check(readObject(board.tms, 0x2600, 1, 4) == start + readingLoops, "one sequence number per sweep that read");
+    check(readObject(board.tms, 0x2600, 2, 4) == latestReadMs(board), "time of the latest read, not of the loop");
+    for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+        auto temp = static_cast<int16_t>(readObject(board.tms, 0x2101, i + 1, 2));
+        check(temp == board.sensorTemps[i], "TPDO objects hold the published readings");
+    }
+
+    // process() publishes, the objects only change once updatePDOTemps() takes the sweep
+    sequence = readObject(board.tms, 0x2600, 1, 4);
+    board.simSensors[2].setTemperature(50.0);
+    board.pollEverySensor();
+    board.tms.process();
+    check(readObject(board.tms, 0x2600, 1, 4) == sequence, "process() leaves 0x2600");
+    check(static_cast<int16_t>(readObject(board.tms, 0x2101, 3, 2)) != board.sensorTemps[2],
+          "process() leaves the TPDO objects");
+    board.tms.updatePDOTemps();
+    check(readObject(board.tms, 0x2600, 1, 4) == sequence + 1, "updatePDOTemps() takes the new sweep");
+    check(static_cast<int16_t>(readObject(board.tms, 0x2101, 3, 2)) == board.sensorTemps[2],
+          "updatePDOTemps() refreshes the TPDO objects");
+
+    // Taking the same sweep again changes nothing
+    board.tms.updatePDOTemps();
+    check(readObject(board.tms, 0x2600, 1, 4) == sequence + 1, "no new sweep, no new sequence number");
+
+    if (failures) {
+        std::fprintf(stderr, "%d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("All checks passed, %u of 3000 iterations read a sensor\n", static_cast<unsigned>(readingLoops));
+    return 0;
+}
@@ -0,0 +1,131 @@
+/**
+ * Checks that programming calibration offsets into the TMP117 EEPROM is spread over the sweeps of the simulated board
+ * instead of blocking one of them, and that the configuration is only programmed when the EEPROM may not hold it. Exits
+ * non-zero if any check fails.
+ */
+
+#include <cstdio>
+
+#include <core/utils/time.hpp>
+#include <sim/SimBoard.hpp>
+#include <sim/SimClock.hpp>
+
+namespace time = core::time;
+
+namespace {
+
+int failures = 0;
+
+/**
+ * Check a condition, reporting it if it does not hold
+ *
+ * @param[in] condition Whether the check passed
+ * @param[in] what Description of the check
+ */
+void check(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+/**
+ * Sweep the board once per millisecond until no sensor has a calibration request pending
+ *
+ * @param[in] board Board to sweep
+ * @param[out] longestUs Longest sweep, in simulated microseconds
+ * @return Number of sweeps it took
+ */
+uint32_t sweepUntilDone(sim::SimBoard& board, uint64_t& longestUs) {
+    longestUs = 0;
+    for (uint32_t sweeps = 1; sweeps <= 1000; sweeps++) {
+        uint64_t start = sim::SimClock::micros();
+        board.mux.pollAllDevices();
+        uint64_t elapsed = sim::SimClock::micros() - start;
+        longestUs        = elapsed > longestUs ? elapsed : longestUs;
+
+        bool pending = false;
+        for (TMS::TMP117& sensor : board.sensors) {
+            pending |= sensor.calibrationStatus() == TMS::TMP117::CalibrationStatus::PENDING;
+        }
+        if (!pending) {
+            return sweeps;
+        }
+        time::wait(1);
+    }
+    return 0;
+}
+
+} // namespace
+
+int main() {
+    sim::SimClock::reset();
+    sim::SimBoard board;
+    board.i2c.setAdvanceClock(true);
+    uint64_t longestUs;
+
+    // The first sweep reads the factory offsets and configuration back
+    board.mux.pollAllDevices();
+    for (TMS::TMP117& sensor : board.sensors) {
+        check(sensor.calibrationStatus() == TMS::TMP117::CalibrationStatus::VERIFIED, "verified at boot");
+    }
+
+    for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+        board.sensors[i].requestOffset(static_cast<int16_t>(25 * (i + 1)), true);
+    }
+    uint32_t sweeps = sweepUntilDone(board, longestUs);
+    check(sweeps > 1, "programming continues over several sweeps");
+    // Waiting for the EEPROM would take at least EEPROM_PROGRAM_US per sensor, on top of the transfers
+    check(longestUs < sim::SimTMP117::EEPROM_PROGRAM_US * NUM_TEMP_SENSORS, "no sweep waits for the EEPROM");
+
+    for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+        int16_t offset = static_cast<int16_t>(25 * (i + 1));
+        auto raw       = static_cast<uint16_t>(TMS::TMP117::fromCentiCelsius(offset));
+        check(board.sensors[i].calibrationStatus() == TMS::TMP117::CalibrationStatus::PERSISTED, "offset persisted");
+        check(board.simSensors[i].eeprom(sim::SimTMP117::TEMP_OFFSET) == raw, "offset programmed into EEPROM");
+        check(board.simSensors[i].eeprom(sim::SimTMP117::CONFIGURATION) == TMS::TMP117::DEFAULT_CONFIG,
+              "configuration kept in EEPROM");
+        check(board.simSensors[i].eepromWrites == 1, "configuration read at boot not programmed again");
+        check(board.simSensors[i].reg(sim::SimTMP117::EEPROM_UL) == 0, "EEPROM locked again");
+    }
+
+    // The programmed offsets are loaded at power up and read back on request. The sensors also load the power up
+    // configuration, which no longer matches the conversions set for their poll periods.
+    for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+        board.simSensors[i].powerCycle();
+        board.sensors[i].requestVerify();
+    }
+    sweepUntilDone(board, longestUs);
+    for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+        check(board.sensors[i].calibrationStatus() == TMS::TMP117::CalibrationStatus::FAILED, "reset reported");
+        check(board.sensors[i].offset() == 25 * (i + 1), "offset loaded from EEPROM");
+    }
+
+    // Without a read back before the conversions are switched, the EEPROM may hold another configuration
+    sim::SimBoard unread;
+    unread.i2c.setAdvanceClock(true);
+    for (TMS::TMP117& sensor : unread.sensors) {
+        sensor.requestOffset(50, true);
+    }
+    sweepUntilDone(unread, longestUs);
+    for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+        check(unread.sensors[i].calibrationStatus() == TMS::TMP117::CalibrationStatus::PERSISTED, "persisted unread");
+        check(unread.simSensors[i].eepromWrites == 2, "configuration and offset programmed");
+    }
+
+    // Once programmed, the configuration is not programmed again
+    for (TMS::TMP117& sensor : unread.sensors) {
+        sensor.requestOffset(75, true);
+    }
+    sweepUntilDone(unread, longestUs);
+    for (uint8_t i = 0; i < NUM_TEMP_SENSORS; i++) {
+        check(unread.simSensors[i].eepromWrites == 3, "only the offset programmed again");
+    }
+
+    if (failures) {
+        std::fprintf(stderr, "%d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("All checks passed in %u sweeps\n", static_cast<unsigned>(sweeps));
+    return 0;
+}
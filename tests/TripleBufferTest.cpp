@@ -0,0 +1,69 @@
+/**
+ * Publishes through a TripleBuffer from one thread while reading from another, and checks that the reader never sees
+ * a value with parts from two publications or an older publication after a newer one. Exits non-zero if any check
+ * fails. Building with -fsanitize=thread also checks the hand-over for data races.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#include <TripleBuffer.hpp>
+
+namespace {
+
+/** Number of values the producer publishes */
+constexpr uint32_t NUM_PUBLICATIONS = 200000;
+
+/**
+ * Value large enough that a torn copy shows up, every word holds the number of the publication
+ */
+struct Value {
+    uint32_t words[16];
+};
+
+} // namespace
+
+int main() {
+    TMS::TripleBuffer<Value> buffer(Value{});
+
+    std::thread producer([&buffer] {
+        for (uint32_t publication = 1; publication <= NUM_PUBLICATIONS; publication++) {
+            Value& value = buffer.back();
+            for (uint32_t& word : value.words) {
+                word = publication;
+
+                // Let the reader run while the value is half written, even when both threads share one core
+                if (&word == &value.words[8]) {
+                    std::this_thread::yield();
+                }
+            }
+            buffer.publish();
+        }
+    });
+
+    uint64_t updates   = 0;
+    uint64_t torn      = 0;
+    uint64_t backwards = 0;
+    uint32_t last      = 0;
+    while (last < NUM_PUBLICATIONS) {
+        if (!buffer.update()) {
+            std::this_thread::yield();
+            continue;
+        }
+        updates++;
+
+        const Value& value = buffer.front();
+        for (uint32_t word : value.words) {
+            torn += word != value.words[0];
+        }
+        torn += buffer.sequence() != value.words[0];
+        backwards += value.words[0] <= last;
+        last = value.words[0];
+    }
+    producer.join();
+
+    std::printf("%llu updates, %llu torn, %llu out of order\n", static_cast<unsigned long long>(updates),
+                static_cast<unsigned long long>(torn), static_cast<unsigned long long>(backwards));
+    return torn || backwards ? 1 : 0;
+}
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "Bus.hpp"
+
+namespace cansim {
+
+TraceSource::TraceSource(std::vector<Frame> frames, double speed, uint64_t startUs)
+    : frames(std::move(frames)), speed(speed), startUs(startUs) {}
+
+bool TraceSource::next(Frame& frame) {
+    if (position == frames.size()) {
+        return false;
+    }
+    frame        = frames[position++];
+    frame.timeUs = startUs + static_cast<uint64_t>(std::llround(frame.timeUs / speed));
+    return true;
+}
+
+PeriodicSource::PeriodicSource(const Frame& frame, uint64_t periodUs, uint64_t jitterUs, uint32_t seed)
+    : frame(frame), periodUs(periodUs), jitterUs(jitterUs), state(seed ? seed : 1), nextUs(frame.timeUs) {}
+
+bool PeriodicSource::next(Frame& frame) {
+    frame        = this->frame;
+    frame.timeUs = nextUs;
+    nextUs += periodUs;
+
+    if (jitterUs) {
+        // xorshift32 is plenty for spreading transmissions and keeps runs reproducible
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        frame.timeUs += state % (jitterUs + 1);
+    }
+    return true;
+}
+
+Bus::Bus(uint32_t bitrate) : bitrate(bitrate) {}
+
+void Bus::addSource(FrameSource& source, uint8_t sender) {
+    Node node;
+    node.source  = &source;
+    node.sender  = sender;
+    node.hasNext = source.next(node.next);
+    nodes.push_back(node);
+}
+
+void Bus::transmit(const Frame& frame, uint8_t sender) {
+    pending.push_back({frame, sender, sequence++});
+}
+
+void Bus::setReceiver(Receiver receiver) {
+    this->receiver = std::move(receiver);
+}
+
+void Bus::run(uint64_t untilUs) {
+    while (true) {
+        if (busy) {
+            if (busyUntil > untilUs) {
+                return;
+            }
+            busy      = false;
+            idleSince = busyUntil;
+            frames++;
+            if (receiver) {
+                receiver(current.frame, current.sender, busyUntil);
+            }
+            continue;
+        }
+
+        pull(untilUs);
+        if (pending.empty()) {
+            return;
+        }
+
+        uint64_t earliest = pending[0].frame.timeUs;
+        for (const Pending& candidate : pending) {
+            earliest = std::min(earliest, candidate.frame.timeUs);
+        }
+        uint64_t start = std::max(idleSince, earliest);
+        if (start > untilUs) {
+            return;
+        }
+
+        // Arbitration between every frame waiting when the bus goes idle
+        size_t winner = pending.size();
+        size_t ready  = 0;
+        for (size_t i = 0; i < pending.size(); i++) {
+            const Pending& candidate = pending[i];
+            if (candidate.frame.timeUs > start) {
+                continue;
+            }
+            ready++;
+            if (winner == pending.size() || priority(candidate.frame) < priority(pending[winner].frame)
+                || (priority(candidate.frame) == priority(pending[winner].frame)
+                    && candidate.sequence < pending[winner].sequence)) {
+                winner = i;
+            }
+        }
+        maxBacklog = std::max(maxBacklog, ready);
+
+        current = pending[winner];
+        pending.erase(pending.begin() + static_cast<long>(winner));
+        uint64_t duration = frameTimeUs(current.frame);
+        busy              = true;
+        busyUntil         = start + duration;
+        busyUs += duration;
+    }
+}
+
+uint64_t Bus::frameTimeUs(const Frame& frame) const {
+    // Worst case stuffing inserts a bit after every 4 bits of the stuffed part of the frame
+    uint32_t dataBits = 8u * frame.dlc;
+    uint32_t bits;
+    if (frame.extended) {
+        bits = dataBits + 67 + (54 + dataBits - 1) / 4;
+    } else {
+        bits = dataBits + 47 + (34 + dataBits - 1) / 4;
+    }
+    return (static_cast<uint64_t>(bits) * 1000000 + bitrate - 1) / bitrate;
+}
+
+void Bus::pull(uint64_t untilUs) {
+    for (Node& node : nodes) {
+        while (node.hasNext && node.next.timeUs <= untilUs) {
+            transmit(node.next, node.sender);
+            node.hasNext = node.source->next(node.next);
+        }
+    }
+}
+
+uint32_t Bus::priority(const Frame& frame) {
+    if (frame.extended) {
+        return (frame.id >> 18) << 19 | 1u << 18 | (frame.id & 0x3FFFF);
+    }
+    return frame.id << 19;
+}
+
+} // namespace cansim
@@ -0,0 +1,202 @@
+#ifndef TMS_CANSIM_BUS_HPP
+#define TMS_CANSIM_BUS_HPP
+
+#include <functional>
+#include <vector>
+
+#include "Frame.hpp"
+
+namespace cansim {
+
+/**
+ * Supplies the frames a node queues for transmission, in order of their time
+ */
+class FrameSource {
+public:
+    virtual ~FrameSource() = default;
+
+    /**
+     * Get the next frame
+     *
+     * @param[out] frame The next frame, with a time no earlier than the previous one
+     * @return Whether there was another frame
+     */
+    virtual bool next(Frame& frame) = 0;
+};
+
+/**
+ * Replays a recorded trace, compressing its timeline by a speed factor
+ */
+class TraceSource : public FrameSource {
+public:
+    /**
+     * @param[in] frames Frames to replay, sorted by time
+     * @param[in] speed Replay speed, 1 for the recorded timing and 10 for ten times as fast
+     * @param[in] startUs Simulated time the first frame of the trace is sent at
+     */
+    TraceSource(std::vector<Frame> frames, double speed, uint64_t startUs);
+
+    bool next(Frame& frame) override;
+
+private:
+    /** Frames to replay */
+    std::vector<Frame> frames;
+    /** Replay speed */
+    double speed;
+    /** Simulated time the trace starts at */
+    uint64_t startUs;
+    /** Position of the next frame */
+    size_t position = 0;
+};
+
+/**
+ * A node that sends the same frame periodically, to generate bus load
+ */
+class PeriodicSource : public FrameSource {
+public:
+    /**
+     * @param[in] frame Frame to send, its time is the first transmission
+     * @param[in] periodUs Time between transmissions
+     * @param[in] jitterUs Maximum random delay added to each transmission
+     * @param[in] seed Seed for the jitter
+     */
+    PeriodicSource(const Frame& frame, uint64_t periodUs, uint64_t jitterUs, uint32_t seed);
+
+    bool next(Frame& frame) override;
+
+private:
+    /** Frame to send */
+    Frame frame;
+    /** Time between transmissions */
+    uint64_t periodUs;
+    /** Maximum random delay */
+    uint64_t jitterUs;
+    /** Jitter generator state */
+    uint32_t state;
+    /** Undelayed time of the next transmission */
+    uint64_t nextUs;
+};
+
+/**
+ * Classic CAN bus model. Frames queued by the nodes are serialized one at a time, with the lowest identifier winning
+ * arbitration whenever the bus goes idle, and every completed frame is handed to a receiver. Frame lengths are the
+ * worst case including bit stuffing and the interframe space.
+ */
+class Bus {
+public:
+    /**
+     * Called when a frame has been transmitted
+     *
+     * @param[in] frame The frame, with the time it was queued
+     * @param[in] sender Identifier of the node that sent the frame
+     * @param[in] doneUs Time the last bit of the frame was on the bus
+     */
+    using Receiver = std::function<void(const Frame& frame, uint8_t sender, uint64_t doneUs)>;
+
+    /**
+     * @param[in] bitrate Bus bitrate in bits/s
+     */
+    explicit Bus(uint32_t bitrate);
+
+    /**
+     * Add a node whose frames are pulled from a source as the simulation reaches them
+     *
+     * @param[in] source Frames of the node, must outlive the bus
+     * @param[in] sender Identifier passed to the receiver for these frames
+     */
+    void addSource(FrameSource& source, uint8_t sender);
+
+    /**
+     * Queue a frame for transmission
+     *
+     * @param[in] frame Frame to send, its time must not be before the last time run() reached
+     * @param[in] sender Identifier passed to the receiver for this frame
+     */
+    void transmit(const Frame& frame, uint8_t sender);
+
+    /**
+     * Set the function called for every transmitted frame
+     *
+     * @param[in] receiver Function to call
+     */
+    void setReceiver(Receiver receiver);
+
+    /**
+     * Simulate the bus up to a point in time
+     *
+     * @param[in] untilUs Time to stop at
+     */
+    void run(uint64_t untilUs);
+
+    /**
+     * Get the time a frame occupies the bus
+     *
+     * @param[in] frame Frame to time
+     * @return Transmission time in microseconds
+     */
+    uint64_t frameTimeUs(const Frame& frame) const;
+
+    /** Number of frames transmitted */
+    uint64_t frames = 0;
+    /** Total time the bus was busy */
+    uint64_t busyUs = 0;
+    /** Largest number of frames waiting for the bus at once */
+    size_t maxBacklog = 0;
+
+private:
+    /** A frame waiting for the bus */
+    struct Pending {
+        Frame frame;
+        uint8_t sender;
+        /** Order frames were queued in, breaks ties between equal identifiers */
+        uint64_t sequence;
+    };
+
+    /** A node and its next frame */
+    struct Node {
+        FrameSource* source;
+        uint8_t sender;
+        Frame next;
+        bool hasNext;
+    };
+
+    /** Bus bitrate in bits/s */
+    uint32_t bitrate;
+    /** Nodes with frame sources */
+    std::vector<Node> nodes;
+    /** Frames waiting for the bus */
+    std::vector<Pending> pending;
+    /** Number of frames queued so far */
+    uint64_t sequence = 0;
+    /** Function called for every transmitted frame */
+    Receiver receiver;
+
+    /** Whether a frame is on the bus */
+    bool busy = false;
+    /** Frame on the bus */
+    Pending current;
+    /** Time the frame on the bus completes */
+    uint64_t busyUntil = 0;
+    /** Time the bus last went idle */
+    uint64_t idleSince = 0;
+
+    /**
+     * Move the frames that the sources queue up to a point in time into pending
+     *
+     * @param[in] untilUs Time to pull up to
+     */
+    void pull(uint64_t untilUs);
+
+    /**
+     * Get the arbitration priority of a frame, lower wins. A standard frame wins against an extended frame with the
+     * same base identifier because of the recessive SRR and IDE bits.
+     *
+     * @param[in] frame Frame to rank
+     * @return Priority of the frame
+     */
+    static uint32_t priority(const Frame& frame);
+};
+
+} // namespace cansim
+
+#endif // TMS_CANSIM_BUS_HPP
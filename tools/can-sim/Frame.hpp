@@ -0,0 +1,26 @@
+#ifndef TMS_CANSIM_FRAME_HPP
+#define TMS_CANSIM_FRAME_HPP
+
+#include <cstdint>
+
+namespace cansim {
+
+/**
+ * A classic CAN data frame as seen by the bus model
+ */
+struct Frame {
+    /** Simulated time in microseconds at which the sender queues the frame for transmission */
+    uint64_t timeUs = 0;
+    /** 11 or 29 bit identifier */
+    uint32_t id = 0;
+    /** Whether id is a 29 bit identifier */
+    bool extended = false;
+    /** Number of data bytes, 0 to 8 */
+    uint8_t dlc = 0;
+    /** Data bytes, only the first dlc are valid */
+    uint8_t data[8] = {};
+};
+
+} // namespace cansim
+
+#endif // TMS_CANSIM_FRAME_HPP
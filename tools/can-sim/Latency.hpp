@@ -0,0 +1,78 @@
+#ifndef TMS_CANSIM_LATENCY_HPP
+#define TMS_CANSIM_LATENCY_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace cansim {
+
+/**
+ * Collects time samples and summarizes them
+ */
+class Latency {
+public:
+    /**
+     * Record a sample
+     *
+     * @param[in] us Sample in microseconds
+     */
+    void add(uint64_t us) {
+        samples.push_back(us);
+    }
+
+    /** Number of samples */
+    size_t count() const {
+        return samples.size();
+    }
+
+    /** Smallest sample, 0 without samples */
+    uint64_t min() const {
+        return samples.empty() ? 0 : *std::min_element(samples.begin(), samples.end());
+    }
+
+    /** Largest sample, 0 without samples */
+    uint64_t max() const {
+        return samples.empty() ? 0 : *std::max_element(samples.begin(), samples.end());
+    }
+
+    /** Mean of the samples, 0 without samples */
+    double mean() const {
+        if (samples.empty()) {
+            return 0;
+        }
+        double sum = 0;
+        for (uint64_t sample : samples) {
+            sum += static_cast<double>(sample);
+        }
+        return sum / static_cast<double>(samples.size());
+    }
+
+    /**
+     * Get a percentile using the nearest rank
+     *
+     * @param[in] fraction Percentile as a fraction, 0.99 for p99
+     * @return The percentile, 0 without samples
+     */
+    uint64_t percentile(double fraction) const {
+        if (samples.empty()) {
+            return 0;
+        }
+        std::vector<uint64_t> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        double exact = fraction * static_cast<double>(sorted.size());
+        size_t rank  = static_cast<size_t>(exact);
+        if (static_cast<double>(rank) < exact) {
+            rank++;
+        }
+        return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+    }
+
+private:
+    /** Recorded samples */
+    std::vector<uint64_t> samples;
+};
+
+} // namespace cansim
+
+#endif // TMS_CANSIM_LATENCY_HPP
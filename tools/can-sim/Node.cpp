@@ -0,0 +1,402 @@
+#include <cstring>
+
+#include <core/utils/time.hpp>
+#include <sim/SimClock.hpp>
+
+#include "Node.hpp"
+
+namespace cansim {
+
+namespace {
+
+/** NMT commands */
+constexpr uint8_t NMT_START               = 0x01;
+constexpr uint8_t NMT_STOP                = 0x02;
+constexpr uint8_t NMT_PREOP               = 0x80;
+constexpr uint8_t NMT_RESET_NODE          = 0x81;
+constexpr uint8_t NMT_RESET_COMMUNICATION = 0x82;
+
+/** SDO abort codes */
+constexpr uint32_t SDO_ABORT_COMMAND    = 0x05040001;
+constexpr uint32_t SDO_ABORT_WRITE_ONLY = 0x06010001;
+constexpr uint32_t SDO_ABORT_READ_ONLY  = 0x06010002;
+constexpr uint32_t SDO_ABORT_NO_OBJECT  = 0x06020000;
+constexpr uint32_t SDO_ABORT_LENGTH     = 0x06070010;
+constexpr uint32_t SDO_ABORT_GENERAL    = 0x08000000;
+
+/** Highest TPDO number looked up in the object dictionary */
+constexpr uint16_t MAX_TPDOS = 512;
+
+} // namespace
+
+TMSNode::TMSNode(Bus& bus, uint32_t framesPerLoop, bool operational) : bus(bus), framesPerLoop(framesPerLoop) {
+    board.i2c.setAdvanceClock(true);
+    nodeId       = board.tms.getNodeID();
+    uint64_t now = sim::SimClock::micros();
+
+    dictionary.Node = &stackNode;
+    dictionary.Root = board.tms.getObjectDictionary();
+    dictionary.Num  = board.tms.getNumElements();
+
+    CO_OBJ_T* heartbeat = find(0x1017, 0);
+    if (heartbeat && heartbeat->Data) {
+        periodics.push_back({0x700u + nodeId, heartbeat->Data * 1000ull, now + heartbeat->Data * 1000ull, -1, {}});
+    }
+
+    // Only timer-driven TPDOs are sent on their own, the rest need an application event the firmware never raises
+    for (uint16_t pdo = 0; pdo < MAX_TPDOS; pdo++) {
+        CO_OBJ_T* cobId = find(0x1800 + pdo, 1);
+        if (!cobId) {
+            break;
+        }
+        CO_OBJ_T* timer = find(0x1800 + pdo, 5);
+        if (timer && timer->Data) {
+            periodics.push_back({read(cobId, 4) & 0x7FF, timer->Data * 1000ull, 0, pdo, {}});
+            map(periodics.back());
+        }
+    }
+
+    CO_OBJ_T* rpdo = find(0x1400, 1);
+    if (rpdo) {
+        rpdoCobId = read(rpdo, 4) & 0x7FF;
+    }
+
+    Frame bootup;
+    bootup.id      = 0x700 + nodeId;
+    bootup.dlc     = 1;
+    bootup.data[0] = 0x00;
+    send(bootup, now);
+
+    if (operational) {
+        setMode(CO_OPERATIONAL);
+    }
+}
+
+void TMSNode::step() {
+    uint64_t now = sim::SimClock::micros();
+    if (looped) {
+        loopPeriod.add(now - lastLoopUs);
+    }
+    looped     = true;
+    lastLoopUs = now;
+    depth.add(arrivals.size());
+
+    // Same order as the main loop in main.cpp, with the bus catching up each time the firmware advances the clock
+    board.tms.process();
+    bus.run(sim::SimClock::micros());
+    board.tms.updatePDOTemps();
+    processCANopen();
+    core::time::wait(1);
+    bus.run(sim::SimClock::micros());
+}
+
+void TMSNode::onFrame(const Frame& frame, uint8_t sender, uint64_t doneUs) {
+    if (sender == SENDER) {
+        auto waiting = outstanding.find(frame.id);
+        if (waiting == outstanding.end() || waiting->second.empty()) {
+            return;
+        }
+        uint64_t dueUs = waiting->second.front();
+        waiting->second.pop_front();
+
+        if (frame.id == 0x580u + nodeId) {
+            sdoLatency.add(doneUs - dueUs);
+        } else {
+            periodicLatency[frame.id].add(doneUs - dueUs);
+        }
+        return;
+    }
+
+    // The CAN interrupt
+    received++;
+    if (queue.isFull()) {
+        dropped++;
+        return;
+    }
+    uint8_t payload[8];
+    std::memcpy(payload, frame.data, sizeof(payload));
+    core::io::CANMessage message(frame.id, frame.dlc, payload, frame.extended);
+    TMS::TMS::canInterrupt(message, &queue);
+
+    arrivals.push_back(doneUs);
+    maxDepth = std::max(maxDepth, arrivals.size());
+}
+
+void TMSNode::processCANopen() {
+    for (uint32_t i = 0; i < framesPerLoop; i++) {
+        core::io::CANMessage message;
+        if (!queue.pop(&message)) {
+            break;
+        }
+        uint64_t arrivedUs = arrivals.front();
+        arrivals.pop_front();
+        handle(message, arrivedUs);
+    }
+
+    uint64_t now = sim::SimClock::micros();
+    for (Periodic& periodic : periodics) {
+        if (periodic.pdo >= 0 && mode != CO_OPERATIONAL) {
+            continue;
+        }
+        // Every period that elapsed since the last iteration is sent, late
+        while (periodic.dueUs <= now) {
+            Frame frame;
+            build(periodic, frame);
+            send(frame, periodic.dueUs);
+            periodic.dueUs += periodic.periodUs;
+        }
+    }
+}
+
+void TMSNode::handle(core::io::CANMessage& message, uint64_t arrivedUs) {
+    if (message.isCANExtended()) {
+        return;
+    }
+
+    uint32_t id = message.getId();
+    if (id == 0) {
+        uint8_t* data = message.getPayload();
+        if (message.getDataLength() < 2 || (data[1] != 0 && data[1] != nodeId)) {
+            return;
+        }
+        nmtCommands++;
+
+        switch (data[0]) {
+        case NMT_START:
+            setMode(CO_OPERATIONAL);
+            break;
+        case NMT_STOP:
+            setMode(CO_STOP);
+            break;
+        case NMT_PREOP:
+            setMode(CO_PREOP);
+            break;
+        case NMT_RESET_NODE:
+        case NMT_RESET_COMMUNICATION: {
+            setMode(CO_PREOP);
+            for (Periodic& periodic : periodics) {
+                if (periodic.pdo >= 0) {
+                    map(periodic);
+                }
+            }
+            Frame bootup;
+            bootup.id      = 0x700 + nodeId;
+            bootup.dlc     = 1;
+            bootup.data[0] = 0x00;
+            send(bootup, sim::SimClock::micros());
+            break;
+        }
+        default:
+            break;
+        }
+    } else if (id == 0x600u + nodeId) {
+        if (mode != CO_STOP) {
+            handleSDO(message, arrivedUs);
+        }
+    } else if (rpdoCobId && id == rpdoCobId) {
+        if (mode == CO_OPERATIONAL) {
+            handleRPDO(message);
+        }
+    }
+}
+
+void TMSNode::handleSDO(core::io::CANMessage& request, uint64_t arrivedUs) {
+    // The stack ignores requests that are not a full 8 bytes
+    if (request.getDataLength() != 8) {
+        return;
+    }
+
+    uint8_t* data    = request.getPayload();
+    uint8_t command  = data[0];
+    uint16_t index   = data[1] | data[2] << 8;
+    uint8_t subIndex = data[3];
+    CO_OBJ_T* object = find(index, subIndex);
+    uint8_t size     = object ? sizeOf(object) : 0;
+    uint32_t abort   = 0;
+
+    Frame response;
+    response.id      = 0x580 + nodeId;
+    response.dlc     = 8;
+    response.data[1] = data[1];
+    response.data[2] = data[2];
+    response.data[3] = data[3];
+
+    // Only expedited transfers are modeled, which covers every object of the TMS
+    switch (command >> 5) {
+    case 2: // Upload
+        if (!object) {
+            abort = SDO_ABORT_NO_OBJECT;
+        } else if (!(object->Key & CO_OBJ____R_)) {
+            abort = SDO_ABORT_WRITE_ONLY;
+        } else if (!size) {
+            abort = SDO_ABORT_GENERAL;
+        } else {
+            uint32_t value   = read(object, size);
+            response.data[0] = static_cast<uint8_t>(0x43 | (4 - size) << 2);
+            for (uint8_t i = 0; i < size; i++) {
+                response.data[4 + i] = static_cast<uint8_t>(value >> (8 * i));
+            }
+        }
+        break;
+    case 1: // Download
+        if (!(command & 0x02)) {
+            abort = SDO_ABORT_COMMAND;
+        } else if (!object) {
+            abort = SDO_ABORT_NO_OBJECT;
+        } else if (!(object->Key & CO_OBJ_____W) || (object->Key & CO_OBJ_D____)) {
+            abort = SDO_ABORT_READ_ONLY;
+        } else if (!size || ((command & 0x01) && 4 - ((command >> 2) & 0x03) != size)) {
+            abort = SDO_ABORT_LENGTH;
+        } else {
+            uint32_t value = data[4] | data[5] << 8 | data[6] << 16 | static_cast<uint32_t>(data[7]) << 24;
+            write(object, size, value);
+            response.data[0] = 0x60;
+        }
+        break;
+    default:
+        abort = SDO_ABORT_COMMAND;
+        break;
+    }
+
+    if (abort) {
+        response.data[0] = 0x80;
+        for (uint8_t i = 0; i < 4; i++) {
+            response.data[4 + i] = static_cast<uint8_t>(abort >> (8 * i));
+        }
+        sdoAborts++;
+    }
+    sdoRequests++;
+    send(response, arrivedUs);
+}
+
+void TMSNode::handleRPDO(core::io::CANMessage& message) {
+    CO_OBJ_T* count = find(0x1600, 0);
+    uint8_t* data   = message.getPayload();
+    uint8_t offset  = 0;
+
+    for (uint8_t sub = 1; count && sub <= count->Data; sub++) {
+        uint8_t bits;
+        CO_OBJ_T* object = linked(find(0x1600, sub), bits);
+        uint8_t size     = bits / 8;
+        if (!object || offset + size > message.getDataLength()) {
+            return;
+        }
+
+        uint32_t value = 0;
+        for (uint8_t i = 0; i < size; i++) {
+            value |= static_cast<uint32_t>(data[offset++]) << (8 * i);
+        }
+        if (!(object->Key & CO_OBJ_D____)) {
+            write(object, size, value);
+        }
+    }
+    rpdos++;
+}
+
+void TMSNode::setMode(CO_MODE newMode) {
+    if (newMode == mode) {
+        return;
+    }
+    mode = newMode;
+
+    // TPDO timers start over when the node becomes operational
+    if (mode == CO_OPERATIONAL) {
+        uint64_t now = sim::SimClock::micros();
+        for (Periodic& periodic : periodics) {
+            if (periodic.pdo >= 0) {
+                periodic.dueUs = now + periodic.periodUs;
+            }
+        }
+    }
+    board.tms.setMode(newMode);
+}
+
+void TMSNode::send(Frame& frame, uint64_t dueUs) {
+    frame.timeUs = sim::SimClock::micros();
+    outstanding[frame.id].push_back(dueUs);
+    bus.transmit(frame, SENDER);
+}
+
+void TMSNode::build(const Periodic& periodic, Frame& frame) {
+    frame.id = periodic.cobId;
+    if (periodic.pdo < 0) {
+        frame.dlc     = 1;
+        frame.data[0] = mode == CO_OPERATIONAL ? 0x05 : mode == CO_STOP ? 0x04 : 0x7F;
+        return;
+    }
+
+    uint8_t offset = 0;
+    for (const auto& object : periodic.mapped) {
+        uint8_t size   = object.second / 8;
+        uint32_t value = read(object.first, size);
+        for (uint8_t i = 0; i < size; i++) {
+            frame.data[offset++] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+    frame.dlc = offset;
+}
+
+void TMSNode::map(Periodic& periodic) {
+    uint16_t mappingIndex = 0x1A00 + periodic.pdo;
+    CO_OBJ_T* count       = find(mappingIndex, 0);
+    uint8_t offset        = 0;
+
+    periodic.mapped.clear();
+    for (uint8_t sub = 1; count && sub <= count->Data; sub++) {
+        uint8_t bits;
+        CO_OBJ_T* object = linked(find(mappingIndex, sub), bits);
+        uint8_t size     = bits / 8;
+        if (!object || offset + size > 8) {
+            break;
+        }
+        periodic.mapped.emplace_back(object, bits);
+        offset += size;
+    }
+}
+
+CO_OBJ_T* TMSNode::find(uint16_t index, uint8_t subIndex) {
+    return CODictFind(&dictionary, CO_DEV(index, subIndex));
+}
+
+CO_OBJ_T* TMSNode::linked(CO_OBJ_T* mapping, uint8_t& bits) {
+    if (!mapping) {
+        return nullptr;
+    }
+    uint32_t link = read(mapping, 4);
+    bits          = static_cast<uint8_t>(link & 0xFF);
+    return find(link >> 16, (link >> 8) & 0xFF);
+}
+
+uint32_t TMSNode::read(CO_OBJ_T* object, uint8_t size) {
+    if (object->Key & CO_OBJ_D____) {
+        uint32_t value = static_cast<uint32_t>(object->Data);
+        if (object->Key & CO_OBJ__N___) {
+            value += nodeId;
+        }
+        return value;
+    }
+
+    // Data links point at the variable, which is little-endian like the CANopen payload on both targets
+    uint32_t value = 0;
+    std::memcpy(&value, reinterpret_cast<void*>(object->Data), size);
+    return value;
+}
+
+void TMSNode::write(CO_OBJ_T* object, uint8_t size, uint32_t value) {
+    std::memcpy(reinterpret_cast<void*>(object->Data), &value, size);
+}
+
+uint8_t TMSNode::sizeOf(const CO_OBJ_T* object) {
+    if (object->Type == CO_TUNSIGNED8 || object->Type == CO_TSIGNED8) {
+        return 1;
+    }
+    if (object->Type == CO_TUNSIGNED16 || object->Type == CO_TSIGNED16) {
+        return 2;
+    }
+    if (object->Type == CO_TUNSIGNED32 || object->Type == CO_TSIGNED32) {
+        return 4;
+    }
+    return 0;
+}
+
+} // namespace cansim
@@ -0,0 +1,235 @@
+#ifndef TMS_CANSIM_NODE_HPP
+#define TMS_CANSIM_NODE_HPP
+
+#include <deque>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <core/io/CANopen.hpp>
+#include <core/io/types/CANMessage.hpp>
+#include <core/utils/types/FixedQueue.hpp>
+#include <sim/SimBoard.hpp>
+
+#include "Bus.hpp"
+#include "Latency.hpp"
+
+namespace cansim {
+
+/**
+ * The TMS firmware on the simulated bus. Received frames go through TMS::canInterrupt() into a FixedQueue the size of
+ * the firmware's CANopen queue, and the main loop of targets/REV3-TMS/main.cpp is run against simulated time: the
+ * real TMS::process() with the I2C bus time of a sweep, the CANopen node, then a 1 ms wait.
+ *
+ * The CANopen node is a model of what processCANopenNode() does with the stack, driven by the TMS object dictionary:
+ * it pops a limited number of frames per iteration, answers expedited SDO transfers, applies the RPDO mapping, follows
+ * NMT commands and sends the timer-driven TPDOs and the heartbeat once the main loop gets to them.
+ */
+class TMSNode {
+public:
+    /** Sender identifier of the TMS on the bus */
+    static constexpr uint8_t SENDER = 0;
+
+    /**
+     * Boot the node. The bootup message is queued at the current simulated time.
+     *
+     * @param[in] bus Bus the node is on
+     * @param[in] framesPerLoop Frames taken off the queue per main loop iteration
+     * @param[in] operational Whether to start as if an NMT start had been received
+     */
+    TMSNode(Bus& bus, uint32_t framesPerLoop, bool operational);
+
+    TMSNode(const TMSNode&) = delete;
+
+    TMSNode& operator=(const TMSNode&) = delete;
+
+    /**
+     * Run one main loop iteration, advancing the simulated clock and the bus
+     */
+    void step();
+
+    /**
+     * Handle a frame transmitted on the bus, either received through the CAN interrupt or completing one of ours
+     *
+     * @param[in] frame Frame on the bus
+     * @param[in] sender Node that sent the frame
+     * @param[in] doneUs Time the frame completed
+     */
+    void onFrame(const Frame& frame, uint8_t sender, uint64_t doneUs);
+
+    /** Simulated board running the firmware */
+    sim::SimBoard board;
+
+    /** Frames received through the CAN interrupt */
+    uint64_t received = 0;
+    /** Frames lost because the queue was full */
+    uint64_t dropped = 0;
+    /** Largest queue occupancy */
+    size_t maxDepth = 0;
+    /** Queue occupancy at the start of each main loop iteration */
+    Latency depth;
+    /** Time between the starts of main loop iterations */
+    Latency loopPeriod;
+    /** Time from an SDO request being received to its response completing on the bus */
+    Latency sdoLatency;
+    /** Time from a periodic transmission being due to it completing on the bus, by COB-ID */
+    std::map<uint32_t, Latency> periodicLatency;
+
+    /** NMT commands addressed to the node */
+    uint64_t nmtCommands = 0;
+    /** SDO requests answered, including aborts */
+    uint64_t sdoRequests = 0;
+    /** SDO requests answered with an abort */
+    uint64_t sdoAborts = 0;
+    /** RPDOs applied to the object dictionary */
+    uint64_t rpdos = 0;
+
+private:
+    /** A timer-driven transmission */
+    struct Periodic {
+        /** COB-ID of the frame */
+        uint32_t cobId;
+        /** Time between transmissions */
+        uint64_t periodUs;
+        /** Time the next transmission is due */
+        uint64_t dueUs;
+        /** TPDO number, or -1 for the heartbeat */
+        int pdo;
+        /** Objects the TPDO carries with their size in bits, read from its mapping when communication is reset */
+        std::vector<std::pair<CO_OBJ_T*, uint8_t>> mapped;
+    };
+
+    /** Bus the node is on */
+    Bus& bus;
+    /** Frames taken off the queue per main loop iteration */
+    uint32_t framesPerLoop;
+    /** Queue filled by the CAN interrupt, as in main.cpp */
+    core::types::FixedQueue<CANOPEN_QUEUE_SIZE, core::io::CANMessage> queue;
+    /** Time each queued frame completed on the bus, in queue order */
+    std::deque<uint64_t> arrivals;
+    /** NMT state of the node */
+    CO_MODE mode = CO_PREOP;
+    /** Node ID from the object dictionary */
+    uint8_t nodeId;
+    /** Stand-in for the CANopen node, only used by the stack's dictionary lookup to report missing objects */
+    CO_NODE stackNode = {};
+    /** The board's object dictionary, searched with the stack's own lookup */
+    CO_DICT dictionary = {};
+    /** COB-ID of the RPDO, 0 if there is none */
+    uint32_t rpdoCobId = 0;
+    /** Heartbeat and TPDOs */
+    std::vector<Periodic> periodics;
+    /** Start of the previous main loop iteration */
+    uint64_t lastLoopUs = 0;
+    /** Whether a main loop iteration has run */
+    bool looped = false;
+    /** Due times of transmissions waiting for the bus, by COB-ID */
+    std::map<uint32_t, std::deque<uint64_t>> outstanding;
+
+    /**
+     * Take frames off the queue and run the timers, as processCANopenNode() does
+     */
+    void processCANopen();
+
+    /**
+     * Handle a frame taken off the queue
+     *
+     * @param[in] message The frame
+     * @param[in] arrivedUs Time the frame completed on the bus
+     */
+    void handle(core::io::CANMessage& message, uint64_t arrivedUs);
+
+    /**
+     * Answer an SDO request
+     *
+     * @param[in] request The request
+     * @param[in] arrivedUs Time the request completed on the bus
+     */
+    void handleSDO(core::io::CANMessage& request, uint64_t arrivedUs);
+
+    /**
+     * Apply an RPDO to the mapped objects
+     *
+     * @param[in] message The RPDO
+     */
+    void handleRPDO(core::io::CANMessage& message);
+
+    /**
+     * Change NMT state and tell the TMS, as CONmtModeChange() does in main.cpp
+     *
+     * @param[in] newMode New NMT state
+     */
+    void setMode(CO_MODE newMode);
+
+    /**
+     * Queue a frame for transmission and remember when it was due
+     *
+     * @param[in] frame Frame to send
+     * @param[in] dueUs Reference time the latency of the frame is measured from
+     */
+    void send(Frame& frame, uint64_t dueUs);
+
+    /**
+     * Build the frame of a timer-driven transmission
+     *
+     * @param[in] periodic The transmission
+     * @param[out] frame The frame to send
+     */
+    void build(const Periodic& periodic, Frame& frame);
+
+    /**
+     * Read the mapping of a TPDO, as the stack does when communication is reset. Changes written to the mapping over
+     * SDO take effect from then on.
+     *
+     * @param[in,out] periodic The TPDO
+     */
+    void map(Periodic& periodic);
+
+    /**
+     * Find an object the way the CANopen stack does
+     *
+     * @param[in] index Object index
+     * @param[in] subIndex Object sub-index
+     * @return The object, or nullptr if it does not exist
+     */
+    CO_OBJ_T* find(uint16_t index, uint8_t subIndex);
+
+    /**
+     * Find the object a PDO mapping entry links to
+     *
+     * @param[in] mapping Mapping entry
+     * @param[out] bits Size of the mapped value in bits
+     * @return The linked object, or nullptr
+     */
+    CO_OBJ_T* linked(CO_OBJ_T* mapping, uint8_t& bits);
+
+    /**
+     * Read the value of an object
+     *
+     * @param[in] object Object to read
+     * @param[in] size Size of the value in bytes
+     * @return The value
+     */
+    uint32_t read(CO_OBJ_T* object, uint8_t size);
+
+    /**
+     * Write the value of an object that links to a variable
+     *
+     * @param[in] object Object to write
+     * @param[in] size Size of the value in bytes
+     * @param[in] value The value
+     */
+    static void write(CO_OBJ_T* object, uint8_t size, uint32_t value);
+
+    /**
+     * Get the size of the value of an object from its type
+     *
+     * @param[in] object Object to size
+     * @return Size in bytes, 0 for types without a fixed size
+     */
+    static uint8_t sizeOf(const CO_OBJ_T* object);
+};
+
+} // namespace cansim
+
+#endif // TMS_CANSIM_NODE_HPP
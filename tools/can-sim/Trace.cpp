@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+
+#include "Trace.hpp"
+
+namespace cansim {
+
+namespace {
+
+/** Split a line on whitespace */
+std::vector<std::string> split(const std::string& line) {
+    std::vector<std::string> tokens;
+    size_t pos = 0;
+    while (pos < line.size()) {
+        size_t start = line.find_first_not_of(" \t\r\n", pos);
+        if (start == std::string::npos) {
+            break;
+        }
+        size_t end = line.find_first_of(" \t\r\n", start);
+        if (end == std::string::npos) {
+            end = line.size();
+        }
+        tokens.push_back(line.substr(start, end - start));
+        pos = end;
+    }
+    return tokens;
+}
+
+/** Parse a string made only of hex digits */
+bool parseHex(const std::string& text, uint32_t& value) {
+    if (text.empty() || text.size() > 8) {
+        return false;
+    }
+    value = 0;
+    for (char c : text) {
+        int digit;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            digit = c - 'A' + 10;
+        } else {
+            return false;
+        }
+        value = value << 4 | digit;
+    }
+    return true;
+}
+
+/** Parse a decimal number of seconds */
+bool parseSeconds(const std::string& text, double& seconds) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end;
+    seconds = std::strtod(text.c_str(), &end);
+    return *end == '\0';
+}
+
+/** Parse an identifier, which is extended when longer than 3 digits or marked with a trailing x as in ASC logs */
+bool parseId(std::string text, Frame& frame) {
+    frame.extended = text.size() > 3;
+    if (!text.empty() && (text.back() == 'x' || text.back() == 'X')) {
+        frame.extended = true;
+        text.pop_back();
+    }
+    return parseHex(text, frame.id) && frame.id <= (frame.extended ? 0x1FFFFFFFu : 0x7FFu);
+}
+
+/** Parse dlc data bytes given as separate hex tokens */
+bool parseBytes(const std::vector<std::string>& tokens, size_t first, Frame& frame) {
+    if (frame.dlc > 8 || first + frame.dlc > tokens.size()) {
+        return false;
+    }
+    for (uint8_t i = 0; i < frame.dlc; i++) {
+        uint32_t byte;
+        if (tokens[first + i].size() > 2 || !parseHex(tokens[first + i], byte)) {
+            return false;
+        }
+        frame.data[i] = static_cast<uint8_t>(byte);
+    }
+    return true;
+}
+
+/** Flag candump sets in the identifier of error frames */
+constexpr uint32_t CAN_ERR_FLAG = 0x20000000;
+
+/** Words starting the header lines of ASC logs */
+const char* const ASC_HEADER_WORDS[] = {"date", "base", "internal", "no", "Begin", "End"};
+
+/**
+ * What a line of a trace holds
+ */
+enum class LineKind {
+    /** A data frame */
+    FRAME,
+    /** Not a data frame and skipped on purpose, like comments, headers and remote, error and CAN FD frames */
+    SKIPPED,
+    /** Nothing that could be parsed */
+    INVALID,
+};
+
+/**
+ * A frame of the trace with its timestamp as written
+ */
+struct TracedFrame {
+    Frame frame;
+    /** Timestamp in seconds, only set if timed is */
+    double seconds;
+    /** Whether the line had a timestamp */
+    bool timed;
+};
+
+/** Parse the ID#DATA notation of candump log files */
+LineKind parseCompact(const std::string& text, Frame& frame) {
+    size_t hash = text.find('#');
+    uint32_t id;
+    if (hash == 8 && parseHex(text.substr(0, hash), id) && (id & CAN_ERR_FLAG)) {
+        return LineKind::SKIPPED;
+    }
+    if (!parseId(text.substr(0, hash), frame)) {
+        return LineKind::INVALID;
+    }
+
+    // ## is CAN FD and #R is a remote frame, neither of which the TMS sees
+    std::string data = text.substr(hash + 1);
+    if (!data.empty() && (data.front() == '#' || data.front() == 'R' || data.front() == 'r')) {
+        return LineKind::SKIPPED;
+    }
+    data.erase(std::remove(data.begin(), data.end(), '.'), data.end());
+    if (data.size() % 2 != 0 || data.size() > 16) {
+        return LineKind::INVALID;
+    }
+
+    frame.dlc = static_cast<uint8_t>(data.size() / 2);
+    for (uint8_t i = 0; i < frame.dlc; i++) {
+        uint32_t byte;
+        if (!parseHex(data.substr(i * 2, 2), byte)) {
+            return LineKind::INVALID;
+        }
+        frame.data[i] = static_cast<uint8_t>(byte);
+    }
+    return LineKind::FRAME;
+}
+
+/** Parse the time channel id direction d dlc data... lines of ASC logs */
+LineKind parseAsc(const std::vector<std::string>& tokens, Frame& frame) {
+    // Error frames, status and statistics events have no direction and type after the identifier
+    if (tokens.size() < 5 || (tokens[4] != "d" && tokens[4] != "r")) {
+        return LineKind::SKIPPED;
+    }
+    if (!parseId(tokens[2], frame)) {
+        return LineKind::INVALID;
+    }
+    if (tokens[4] == "r") {
+        return LineKind::SKIPPED;
+    }
+
+    uint32_t dlc;
+    if (tokens.size() < 6 || tokens[5].size() != 1 || !parseHex(tokens[5], dlc)) {
+        return LineKind::INVALID;
+    }
+    frame.dlc = static_cast<uint8_t>(dlc);
+    return parseBytes(tokens, 6, frame) ? LineKind::FRAME : LineKind::INVALID;
+}
+
+/**
+ * Parse one line of a trace
+ *
+ * @param[in] line Line to parse
+ * @param[out] traced Parsed frame, without its time
+ * @return What the line held
+ */
+LineKind parseLine(const std::string& line, TracedFrame& traced) {
+    std::vector<std::string> tokens = split(line);
+    double& seconds                 = traced.seconds;
+    traced.timed                    = false;
+    if (tokens.empty() || tokens[0].compare(0, 2, "//") == 0 || tokens[0].front() == '#') {
+        return LineKind::SKIPPED;
+    }
+
+    // candump, optionally with a (timestamp) in front
+    size_t i                 = 0;
+    const std::string& first = tokens[0];
+    if (first.size() > 2 && first.front() == '(' && first.back() == ')') {
+        if (!parseSeconds(first.substr(1, first.size() - 2), seconds)) {
+            return LineKind::INVALID;
+        }
+        traced.timed = true;
+        i            = 1;
+    } else if (parseSeconds(first, seconds)) {
+        traced.timed = true;
+        return parseAsc(tokens, traced.frame);
+    } else {
+        for (const char* word : ASC_HEADER_WORDS) {
+            if (first == word) {
+                return LineKind::SKIPPED;
+            }
+        }
+    }
+
+    if (i + 1 >= tokens.size()) {
+        return LineKind::INVALID;
+    }
+    if (tokens[i + 1].find('#') != std::string::npos) {
+        return parseCompact(tokens[i + 1], traced.frame);
+    }
+
+    // interface id [dlc] data..., where CAN FD frames have a two digit [len]
+    Frame& frame           = traced.frame;
+    const std::string& dlc = i + 2 < tokens.size() ? tokens[i + 2] : "";
+    uint32_t id;
+    if (parseHex(tokens[i + 1], id) && tokens[i + 1].size() == 8 && (id & CAN_ERR_FLAG)) {
+        return LineKind::SKIPPED;
+    }
+    if (dlc.size() == 4 && dlc.front() == '[' && dlc.back() == ']') {
+        return LineKind::SKIPPED;
+    }
+    if (dlc.size() != 3 || dlc.front() != '[' || dlc.back() != ']' || dlc[1] < '0' || dlc[1] > '8'
+        || !parseId(tokens[i + 1], frame)) {
+        return LineKind::INVALID;
+    }
+    frame.dlc = static_cast<uint8_t>(dlc[1] - '0');
+    if (i + 3 < tokens.size() && tokens[i + 3] == "remote") {
+        return LineKind::SKIPPED;
+    }
+    return parseBytes(tokens, i + 3, frame) ? LineKind::FRAME : LineKind::INVALID;
+}
+
+} // namespace
+
+bool loadTrace(const std::string& path, TimestampMode mode, std::vector<Frame>& frames,
+               std::vector<std::string>& unparsed, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "could not open " + path;
+        return false;
+    }
+
+    std::vector<TracedFrame> traced;
+    std::string line;
+    uint32_t number = 0;
+    unparsed.clear();
+    while (std::getline(file, line)) {
+        number++;
+        TracedFrame parsed;
+        switch (parseLine(line, parsed)) {
+        case LineKind::FRAME:
+            traced.push_back(parsed);
+            break;
+        case LineKind::INVALID:
+            unparsed.push_back(std::to_string(number) + ": " + line);
+            break;
+        case LineKind::SKIPPED:
+            break;
+        }
+    }
+
+    if (traced.empty()) {
+        error = "no CAN data frames in " + path;
+        return false;
+    }
+
+    frames.clear();
+    bool haveBase   = false;
+    double base     = 0;
+    double elapsed  = 0;
+    uint64_t lastUs = 0;
+    for (TracedFrame& parsed : traced) {
+        if (parsed.timed && mode == TimestampMode::DELTA) {
+            elapsed += std::max(0.0, parsed.seconds);
+            lastUs = static_cast<uint64_t>(std::llround(elapsed * 1e6));
+        } else if (parsed.timed) {
+            if (!haveBase) {
+                base     = parsed.seconds;
+                haveBase = true;
+            }
+            double offset = std::max(0.0, parsed.seconds - base);
+            lastUs        = static_cast<uint64_t>(std::llround(offset * 1e6));
+        }
+        parsed.frame.timeUs = lastUs;
+        frames.push_back(parsed.frame);
+    }
+
+    // Logs from several interfaces can be slightly out of order
+    std::stable_sort(frames.begin(), frames.end(), [](const Frame& a, const Frame& b) { return a.timeUs < b.timeUs; });
+    return true;
+}
+
+} // namespace cansim
@@ -0,0 +1,45 @@
+#ifndef TMS_CANSIM_TRACE_HPP
+#define TMS_CANSIM_TRACE_HPP
+
+#include <string>
+#include <vector>
+
+#include "Frame.hpp"
+
+namespace cansim {
+
+/**
+ * How the timestamps of a trace are read
+ */
+enum class TimestampMode {
+    /** Each timestamp is the time of the frame, as printed by candump without -t or with -ta and -tz */
+    ABSOLUTE,
+    /** Each timestamp is the time since the previous frame, as printed by candump -td */
+    DELTA,
+};
+
+/**
+ * Load a recorded CAN trace. The format is detected per line, so the following can be mixed:
+ *
+ * - candump log files (candump -l): (1436509052.249713) can0 602#2F00230105
+ * - candump output, with or without a -t timestamp: (1436509052.249713) can0 602 [5] 2F 00 23 01 05
+ * - Vector ASC logs: 1.234567 1 602 Rx d 5 2F 00 23 01 05
+ *
+ * Remote, error and CAN FD frames, comments and ASC header and event lines are skipped. Every other line that is not a
+ * data frame, such as the date stamped output of candump -tA, is listed in unparsed. Lines without a timestamp are given
+ * the time of the previous frame, so they arrive as a back-to-back burst. Frame times are made relative to the first
+ * frame.
+ *
+ * @param[in] path Trace file to read
+ * @param[in] mode How the timestamps are read, candump prints -td deltas like any other timestamp
+ * @param[out] frames Frames sorted by time
+ * @param[out] unparsed Lines that could not be parsed, as "LINE: TEXT"
+ * @param[out] error Reason the trace could not be loaded
+ * @return Whether the trace was loaded
+ */
+bool loadTrace(const std::string& path, TimestampMode mode, std::vector<Frame>& frames,
+               std::vector<std::string>& unparsed, std::string& error);
+
+} // namespace cansim
+
+#endif // TMS_CANSIM_TRACE_HPP
@@ -0,0 +1,371 @@
+/**
+ * CAN trace replay and bus load simulator for the TMS. Recorded traces and generated nodes are put on a simulated bus
+ * that the TMS firmware receives from through its CAN interrupt, and the queue occupancy, drops, SDO response latency
+ * and TPDO jitter of the node are reported. Exits with 1 when a --fail-on-drop or --max-* limit is exceeded.
+ *
+ * Usage: tms-can-sim [TRACE] [--speed X] [--duration S] [--bitrate BPS] [--node ID:DLC:PERIOD_MS[:JITTER_MS[:DATA]]]
+ *                    [--operational] [--frames-per-loop N] [--keep-own] [--seed N] [--json FILE]
+ *                    [--fail-on-drop] [--max-sdo-ms MS] [--max-tpdo-jitter-ms MS] [--timestamps absolute|delta]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sim/SimClock.hpp>
+
+#include "Bus.hpp"
+#include "Node.hpp"
+#include "Trace.hpp"
+
+namespace {
+
+/** Sender identifier of the replayed trace, generated nodes follow it */
+constexpr uint8_t TRACE_SENDER = 1;
+
+/** Number of unparsed trace lines that are printed */
+constexpr size_t MAX_REPORTED_LINES = 10;
+
+void usage(const char* program) {
+    std::fprintf(stderr,
+                 "Usage: %s [TRACE] [--speed X] [--duration S] [--bitrate BPS]\n"
+                 "       [--node ID:DLC:PERIOD_MS[:JITTER_MS[:DATA]]] [--operational] [--frames-per-loop N]\n"
+                 "       [--keep-own] [--seed N] [--json FILE] [--fail-on-drop] [--max-sdo-ms MS]\n"
+                 "       [--max-tpdo-jitter-ms MS] [--timestamps absolute|delta]\n",
+                 program);
+}
+
+/** A generated node given on the command line */
+struct NodeSpec {
+    cansim::Frame frame;
+    uint64_t periodUs;
+    uint64_t jitterUs;
+};
+
+/** Parse ID:DLC:PERIOD_MS[:JITTER_MS[:DATA]], the data defaulting to zeros */
+bool parseNode(const std::string& text, NodeSpec& spec) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (true) {
+        size_t colon = text.find(':', start);
+        fields.push_back(text.substr(start, colon - start));
+        if (colon == std::string::npos) {
+            break;
+        }
+        start = colon + 1;
+    }
+    if (fields.size() < 3 || fields.size() > 5) {
+        return false;
+    }
+
+    char* end;
+    unsigned long id = std::strtoul(fields[0].c_str(), &end, 16);
+    if (*end || id > 0x1FFFFFFF) {
+        return false;
+    }
+    unsigned long dlc = std::strtoul(fields[1].c_str(), &end, 10);
+    if (*end || dlc > 8) {
+        return false;
+    }
+    double periodMs = std::strtod(fields[2].c_str(), &end);
+    if (*end || periodMs <= 0) {
+        return false;
+    }
+    double jitterMs = 0;
+    if (fields.size() > 3) {
+        jitterMs = std::strtod(fields[3].c_str(), &end);
+        if (*end || jitterMs < 0 || jitterMs > periodMs) {
+            return false;
+        }
+    }
+
+    spec.frame.id       = static_cast<uint32_t>(id);
+    spec.frame.extended = id > 0x7FF;
+    spec.frame.dlc      = static_cast<uint8_t>(dlc);
+    spec.periodUs       = static_cast<uint64_t>(periodMs * 1000);
+    spec.jitterUs       = static_cast<uint64_t>(jitterMs * 1000);
+    if (spec.periodUs == 0) {
+        return false;
+    }
+
+    if (fields.size() > 4) {
+        const std::string& data = fields[4];
+        if (data.size() != dlc * 2) {
+            return false;
+        }
+        for (size_t i = 0; i < dlc; i++) {
+            unsigned long byte = std::strtoul(data.substr(i * 2, 2).c_str(), &end, 16);
+            if (*end) {
+                return false;
+            }
+            spec.frame.data[i] = static_cast<uint8_t>(byte);
+        }
+    }
+    return true;
+}
+
+/** Whether a frame is one the TMS itself sends, which the simulated node replaces when replaying a trace */
+bool isOwnFrame(const cansim::Frame& frame, uint8_t nodeId) {
+    if (frame.extended || (frame.id & 0x7F) != nodeId) {
+        return false;
+    }
+    switch (frame.id & 0x780) {
+    case 0x180: // TPDOs
+    case 0x280:
+    case 0x380:
+    case 0x480:
+    case 0x580: // SDO responses
+    case 0x700: // Heartbeat
+        return true;
+    default:
+        return false;
+    }
+}
+
+double ms(double us) {
+    return us / 1000;
+}
+
+void printLatency(const cansim::Latency& latency) {
+    std::printf("latency min %.3f ms, mean %.3f ms, p99 %.3f ms, max %.3f ms\n", ms(latency.min()), ms(latency.mean()),
+                ms(latency.percentile(0.99)), ms(latency.max()));
+}
+
+void writeLatency(FILE* file, const cansim::Latency& latency) {
+    std::fprintf(file, "{\"count\": %zu, \"min\": %llu, \"mean\": %.1f, \"p99\": %llu, \"max\": %llu}", latency.count(),
+                 static_cast<unsigned long long>(latency.min()), latency.mean(),
+                 static_cast<unsigned long long>(latency.percentile(0.99)),
+                 static_cast<unsigned long long>(latency.max()));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string tracePath;
+    std::string jsonPath;
+    std::vector<NodeSpec> specs;
+    double speed           = 1;
+    double durationS       = 0;
+    uint32_t bitrate       = 500000;
+    uint32_t framesPerLoop = 1;
+    uint32_t seed          = 1;
+    bool operational       = false;
+    bool keepOwn           = false;
+    bool failOnDrop        = false;
+    double maxSdoMs        = 0;
+    double maxJitterMs     = 0;
+
+    cansim::TimestampMode timestamps = cansim::TimestampMode::ABSOLUTE;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue   = i + 1 < argc;
+
+        if (!std::strcmp(arg, "--operational")) {
+            operational = true;
+        } else if (!std::strcmp(arg, "--keep-own")) {
+            keepOwn = true;
+        } else if (!std::strcmp(arg, "--fail-on-drop")) {
+            failOnDrop = true;
+        } else if (arg[0] != '-') {
+            tracePath = arg;
+        } else if (!hasValue) {
+            usage(argv[0]);
+            return 2;
+        } else if (!std::strcmp(arg, "--speed")) {
+            speed = std::atof(argv[++i]);
+        } else if (!std::strcmp(arg, "--duration")) {
+            durationS = std::atof(argv[++i]);
+        } else if (!std::strcmp(arg, "--bitrate")) {
+            bitrate = static_cast<uint32_t>(std::atol(argv[++i]));
+        } else if (!std::strcmp(arg, "--node")) {
+            NodeSpec spec;
+            if (!parseNode(argv[++i], spec)) {
+                std::fprintf(stderr, "Invalid node %s, expected ID:DLC:PERIOD_MS[:JITTER_MS[:DATA]]\n", argv[i]);
+                return 2;
+            }
+            specs.push_back(spec);
+        } else if (!std::strcmp(arg, "--frames-per-loop")) {
+            framesPerLoop = static_cast<uint32_t>(std::atol(argv[++i]));
+        } else if (!std::strcmp(arg, "--seed")) {
+            seed = static_cast<uint32_t>(std::atol(argv[++i]));
+        } else if (!std::strcmp(arg, "--json")) {
+            jsonPath = argv[++i];
+        } else if (!std::strcmp(arg, "--max-sdo-ms")) {
+            maxSdoMs = std::atof(argv[++i]);
+        } else if (!std::strcmp(arg, "--max-tpdo-jitter-ms")) {
+            maxJitterMs = std::atof(argv[++i]);
+        } else if (!std::strcmp(arg, "--timestamps")) {
+            const char* mode = argv[++i];
+            if (!std::strcmp(mode, "absolute")) {
+                timestamps = cansim::TimestampMode::ABSOLUTE;
+            } else if (!std::strcmp(mode, "delta")) {
+                timestamps = cansim::TimestampMode::DELTA;
+            } else {
+                std::fprintf(stderr, "Invalid timestamp mode %s, expected absolute or delta\n", mode);
+                return 2;
+            }
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (speed <= 0 || bitrate == 0 || framesPerLoop == 0 || durationS < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    sim::SimClock::reset();
+    cansim::Bus bus(bitrate);
+    cansim::TMSNode node(bus, framesPerLoop, operational);
+    bus.setReceiver([&node](const cansim::Frame& frame, uint8_t sender, uint64_t doneUs) {
+        node.onFrame(frame, sender, doneUs);
+    });
+
+    // Traffic starts once the board has booted, which takes a few ms for the pumps to start
+    uint64_t startUs = sim::SimClock::micros();
+
+    std::vector<cansim::Frame> frames;
+    if (!tracePath.empty()) {
+        std::string error;
+        std::vector<std::string> unparsed;
+        bool loaded = cansim::loadTrace(tracePath, timestamps, frames, unparsed, error);
+        if (!unparsed.empty()) {
+            std::fprintf(stderr, "Could not parse %zu lines of %s:\n", unparsed.size(), tracePath.c_str());
+            for (size_t i = 0; i < unparsed.size() && i < MAX_REPORTED_LINES; i++) {
+                std::fprintf(stderr, "  %s\n", unparsed[i].c_str());
+            }
+            if (unparsed.size() > MAX_REPORTED_LINES) {
+                std::fprintf(stderr, "  ...\n");
+            }
+        }
+        if (!loaded) {
+            std::fprintf(stderr, "Could not load trace: %s\n", error.c_str());
+            return 2;
+        }
+
+        uint8_t nodeId = node.board.tms.getNodeID();
+        if (!keepOwn) {
+            std::vector<cansim::Frame> others;
+            for (const cansim::Frame& frame : frames) {
+                if (!isOwnFrame(frame, nodeId)) {
+                    others.push_back(frame);
+                }
+            }
+            frames.swap(others);
+        }
+    }
+    size_t traceFrames = frames.size();
+    uint64_t traceEnd  = frames.empty() ? 0 : static_cast<uint64_t>(frames.back().timeUs / speed);
+    cansim::TraceSource trace(std::move(frames), speed, startUs);
+    if (!tracePath.empty()) {
+        bus.addSource(trace, TRACE_SENDER);
+    }
+
+    // Sources are referenced by the bus, so the storage must not move once they are added
+    std::vector<cansim::PeriodicSource> generated;
+    generated.reserve(specs.size());
+    for (size_t i = 0; i < specs.size(); i++) {
+        specs[i].frame.timeUs = startUs;
+        generated.emplace_back(specs[i].frame, specs[i].periodUs, specs[i].jitterUs, static_cast<uint32_t>(seed + i));
+        bus.addSource(generated.back(), static_cast<uint8_t>(TRACE_SENDER + 1 + i));
+    }
+
+    // Without a duration, run past the end of the trace long enough for its last requests to be answered
+    uint64_t durationUs = static_cast<uint64_t>(durationS * 1e6);
+    if (durationUs == 0) {
+        durationUs = tracePath.empty() ? 10000000 : traceEnd + 1000000;
+    }
+    while (sim::SimClock::micros() < startUs + durationUs) {
+        node.step();
+    }
+    bus.run(sim::SimClock::micros());
+    double elapsedUs = static_cast<double>(sim::SimClock::micros() - startUs);
+
+    double loadPct       = 100.0 * static_cast<double>(bus.busyUs) / elapsedUs;
+    uint64_t maxJitterUs = 0;
+
+    std::printf("Simulated %.3f s", elapsedUs / 1e6);
+    if (!tracePath.empty()) {
+        std::printf(", %zu trace frames from %s at %gx", traceFrames, tracePath.c_str(), speed);
+    }
+    std::printf(", %zu generated nodes\n", specs.size());
+    std::printf("%-16s %u kbit/s, load %.1f %%, %llu frames, arbitration backlog max %zu\n", "CAN bus", bitrate / 1000,
+                loadPct, static_cast<unsigned long long>(bus.frames), bus.maxBacklog);
+    std::printf("%-16s received %llu, dropped %llu, depth max %zu/%d, mean %.2f\n", "RX queue",
+                static_cast<unsigned long long>(node.received), static_cast<unsigned long long>(node.dropped),
+                node.maxDepth, static_cast<int>(CANOPEN_QUEUE_SIZE), node.depth.mean());
+    std::printf("%-16s period min %.3f ms, mean %.3f ms, max %.3f ms, %u frames/iteration\n", "Main loop",
+                ms(node.loopPeriod.min()), ms(node.loopPeriod.mean()), ms(node.loopPeriod.max()), framesPerLoop);
+    std::printf("%-16s %llu commands, %llu RPDOs applied\n", "NMT/RPDO",
+                static_cast<unsigned long long>(node.nmtCommands), static_cast<unsigned long long>(node.rpdos));
+    std::printf("%-16s %llu requests, %llu aborts, ", "SDO", static_cast<unsigned long long>(node.sdoRequests),
+                static_cast<unsigned long long>(node.sdoAborts));
+    printLatency(node.sdoLatency);
+    for (const auto& [cobId, latency] : node.periodicLatency) {
+        char label[32];
+        std::snprintf(label, sizeof(label), "%s 0x%03X", (cobId & 0x780) == 0x700 ? "Heartbeat" : "TPDO",
+                      static_cast<unsigned>(cobId));
+        uint64_t jitterUs = latency.max() - latency.min();
+        if ((cobId & 0x780) != 0x700) {
+            maxJitterUs = std::max(maxJitterUs, jitterUs);
+        }
+        std::printf("%-16s %zu sent, jitter %.3f ms, ", label, latency.count(), ms(jitterUs));
+        printLatency(latency);
+    }
+
+    if (!jsonPath.empty()) {
+        FILE* file = std::fopen(jsonPath.c_str(), "w");
+        if (!file) {
+            std::fprintf(stderr, "Could not write %s\n", jsonPath.c_str());
+            return 2;
+        }
+        std::fprintf(file, "{\n  \"duration_us\": %.0f,\n", elapsedUs);
+        std::fprintf(file,
+                     "  \"bus\": {\"bitrate\": %u, \"load_pct\": %.2f, \"frames\": %llu, \"max_backlog\": %zu},\n",
+                     bitrate, loadPct, static_cast<unsigned long long>(bus.frames), bus.maxBacklog);
+        std::fprintf(file,
+                     "  \"rx\": {\"received\": %llu, \"dropped\": %llu, \"max_depth\": %zu, \"mean_depth\": %.3f, "
+                     "\"capacity\": %d},\n",
+                     static_cast<unsigned long long>(node.received), static_cast<unsigned long long>(node.dropped),
+                     node.maxDepth, node.depth.mean(), static_cast<int>(CANOPEN_QUEUE_SIZE));
+        std::fprintf(file, "  \"loop_period_us\": ");
+        writeLatency(file, node.loopPeriod);
+        std::fprintf(file, ",\n  \"nmt_commands\": %llu,\n  \"rpdos\": %llu,\n",
+                     static_cast<unsigned long long>(node.nmtCommands), static_cast<unsigned long long>(node.rpdos));
+        std::fprintf(file, "  \"sdo\": {\"requests\": %llu, \"aborts\": %llu, \"latency_us\": ",
+                     static_cast<unsigned long long>(node.sdoRequests),
+                     static_cast<unsigned long long>(node.sdoAborts));
+        writeLatency(file, node.sdoLatency);
+        std::fprintf(file, "},\n  \"periodic\": {");
+        bool first = true;
+        for (const auto& [cobId, latency] : node.periodicLatency) {
+            std::fprintf(file, "%s\n    \"0x%03X\": {\"jitter_us\": %llu, \"latency_us\": ", first ? "" : ",",
+                         static_cast<unsigned>(cobId), static_cast<unsigned long long>(latency.max() - latency.min()));
+            writeLatency(file, latency);
+            std::fprintf(file, "}");
+            first = false;
+        }
+        std::fprintf(file, "\n  }\n}\n");
+        std::fclose(file);
+    }
+
+    std::fflush(stdout);
+    int status = 0;
+    if (failOnDrop && node.dropped) {
+        std::fprintf(stderr, "FAIL: %llu frames dropped\n", static_cast<unsigned long long>(node.dropped));
+        status = 1;
+    }
+    if (maxSdoMs > 0 && ms(node.sdoLatency.max()) > maxSdoMs) {
+        std::fprintf(stderr, "FAIL: SDO latency %.3f ms over %.3f ms\n", ms(node.sdoLatency.max()), maxSdoMs);
+        status = 1;
+    }
+    if (maxJitterMs > 0 && ms(maxJitterUs) > maxJitterMs) {
+        std::fprintf(stderr, "FAIL: TPDO jitter %.3f ms over %.3f ms\n", ms(maxJitterUs), maxJitterMs);
+        status = 1;
+    }
+    return status;
+}
@@ -0,0 +1,494 @@
+#!/usr/bin/env python3
+"""Generate C++ pack/unpack code for CAN messages from a DBC file.
+
+Each selected message becomes a struct holding the raw signal values, with
+constexpr pack() and unpack() functions and a table describing its signals.
+Static assertions round trip every signal at the ends of its raw range, so a
+layout or sign extension mistake fails the build.
+The output only depends on the standard library, so the same header is used
+by the firmware and the host tools.
+
+Usage: dbcgen.py DBC --output HEADER [--message NAME]... [--check]
+"""
+
+import argparse
+import os
+import re
+import sys
+
+MESSAGE_RE = re.compile(r'^BO_\s+(\d+)\s+(\w+)\s*:\s*(\d+)\s+(\w+)')
+SIGNAL_RE = re.compile(
+    r'^SG_\s+(\w+)\s*(M|m\d+)?\s*:\s*(\d+)\|(\d+)@([01])([+-])\s*'
+    r'\(([^,]+),([^)]+)\)\s*\[([^|]+)\|([^\]]+)\]\s*"([^"]*)"')
+VALUES_RE = re.compile(r'^VAL_\s+(\d+)\s+(\w+)\s+(.*);')
+VALUE_RE = re.compile(r'(-?\d+)\s+"([^"]*)"')
+COMMENT_RE = re.compile(r'^CM_\s+(BO_|SG_)\s+(\d+)\s+(?:(\w+)\s+)?"([^"]*)";')
+
+# Bit 31 of a DBC message ID marks a 29 bit identifier
+EXTENDED_FLAG = 0x80000000
+
+
+class Signal:
+    def __init__(self, match):
+        self.name = match.group(1)
+        if match.group(2):
+            raise ValueError(f'multiplexed signal {self.name} is not '
+                             'supported')
+        self.start = int(match.group(3))
+        self.length = int(match.group(4))
+        self.little_endian = match.group(5) == '1'
+        self.signed = match.group(6) == '-'
+        self.scale = float(match.group(7))
+        self.offset = float(match.group(8))
+        self.minimum = float(match.group(9))
+        self.maximum = float(match.group(10))
+        self.unit = match.group(11)
+        self.comment = ''
+        self.values = []
+
+        if not 1 <= self.length <= 64:
+            raise ValueError(f'signal {self.name} has length {self.length}')
+
+    def ctype(self):
+        for bits in (8, 16, 32, 64):
+            if self.length <= bits:
+                return f'{"int" if self.signed else "uint"}{bits}_t'
+
+    def shift(self):
+        """Right shift of the signal's LSB in the 64 bit payload word."""
+        if self.little_endian:
+            return self.start
+        # Motorola start bits give the MSB in sawtooth numbering
+        msb = self.start // 8 * 8 + 7 - self.start % 8
+        return 64 - msb - self.length
+
+    def mask(self):
+        return (1 << self.length) - 1
+
+    def limits(self):
+        """Raw values worth round tripping: the ends of the range and -1."""
+        if self.signed:
+            half = 1 << (self.length - 1)
+            return [-half, -1, half - 1]
+        return [self.mask()]
+
+    def literal(self, value):
+        if value == -(1 << 63):
+            return 'INT64_MIN'
+        if value > (1 << 63) - 1:
+            return f'{value}ull'
+        return str(value)
+
+
+class Message:
+    def __init__(self, match):
+        raw_id = int(match.group(1))
+        self.extended = bool(raw_id & EXTENDED_FLAG)
+        self.id = raw_id & ~EXTENDED_FLAG
+        self.name = match.group(2)
+        self.length = int(match.group(3))
+        self.sender = match.group(4)
+        self.comment = ''
+        self.signals = []
+
+    def check(self):
+        for signal in self.signals:
+            shift = signal.shift()
+            if shift < 0 or shift + signal.length > 64:
+                raise ValueError(f'signal {signal.name} is outside the '
+                                 'payload')
+            if signal.little_endian:
+                end = shift + signal.length
+            else:
+                end = 64 - shift
+            if end > self.length * 8:
+                raise ValueError(f'signal {signal.name} does not fit in the '
+                                 f'{self.length} bytes of {self.name}')
+
+
+def parse(path):
+    messages = {}
+    current = None
+    with open(path, encoding='utf-8', errors='replace') as file:
+        for line in file:
+            line = line.strip()
+            match = MESSAGE_RE.match(line)
+            if match:
+                current = Message(match)
+                messages[current.name] = current
+                continue
+            match = SIGNAL_RE.match(line)
+            if match:
+                if current is None:
+                    raise ValueError(f'signal outside a message: {line}')
+                current.signals.append(Signal(match))
+                continue
+            if not line.startswith('SG_'):
+                current = None
+
+            match = COMMENT_RE.match(line)
+            if match:
+                target = find(messages, int(match.group(2)), match.group(3))
+                if target:
+                    target.comment = match.group(4)
+                continue
+            match = VALUES_RE.match(line)
+            if match:
+                target = find(messages, int(match.group(1)), match.group(2))
+                if target:
+                    target.values = [(int(value), label) for value, label
+                                     in VALUE_RE.findall(match.group(3))]
+    return messages
+
+
+def find(messages, raw_id, signal_name):
+    for message in messages.values():
+        if message.id == raw_id & ~EXTENDED_FLAG and \
+                message.extended == bool(raw_id & EXTENDED_FLAG):
+            if signal_name is None:
+                return message
+            for signal in message.signals:
+                if signal.name == signal_name:
+                    return signal
+    return None
+
+
+def identifier(label):
+    name = re.sub(r'\W', '_', label)
+    return '_' + name if name[:1].isdigit() else name
+
+
+def align(out, assignments):
+    """Append consecutive assignments with their = signs lined up."""
+    width = max((len(left) for left, _ in assignments), default=0)
+    for left, right in assignments:
+        out.append(f'{left.ljust(width)} = {right}')
+
+
+def number(value):
+    text = repr(float(value))
+    return text if 'e' in text or '.' in text else text + '.0'
+
+
+def generate_message(message, out):
+    out.append('/**')
+    out.append(f' * {message.name}, sent by {message.sender}' +
+               (f'. {message.comment}' if message.comment else ''))
+    out.append(' */')
+    out.append(f'struct {message.name} {{')
+    members = [('uint32_t ID', f'0x{message.id:X}'),
+               ('bool EXTENDED', 'true' if message.extended else 'false'),
+               ('uint8_t LENGTH', str(message.length)),
+               ('uint8_t NUM_SIGNALS', str(len(message.signals)))]
+    width = max(len(name) for name, _ in members)
+    for name, value in members:
+        out.append(f'    static constexpr {name.ljust(width)} = {value};')
+
+    for signal in message.signals:
+        out.append('')
+        if signal.values:
+            out.append(f'    /** Values of {signal.name} */')
+            out.append(f'    enum {signal.name}Value : {signal.ctype()} {{')
+            align(out, [(f'        {signal.name}_{identifier(label)}',
+                         f'{value},') for value, label in signal.values])
+            out.append('    };')
+            out.append('')
+        description = signal.comment or signal.name
+        unit = f' {signal.unit}' if signal.unit else ''
+        out.append(f'    /** {description}, raw value, '
+                   f'[{signal.minimum:g}, {signal.maximum:g}]{unit} */')
+        out.append(f'    {signal.ctype()} {signal.name} = 0;')
+
+    out.append('')
+    out.append('    /** Layout of each signal, in member order */')
+    out.append('    static constexpr Signal SIGNALS[NUM_SIGNALS] = {')
+    for signal in message.signals:
+        out.append(f'        {{"{signal.name}", "{signal.unit}", '
+                   f'{signal.start}, {signal.length}, '
+                   f'{"true" if signal.little_endian else "false"}, '
+                   f'{"true" if signal.signed else "false"}, '
+                   f'{number(signal.scale)}, {number(signal.offset)}, '
+                   f'{number(signal.minimum)}, {number(signal.maximum)}}},')
+    out.append('    };')
+
+    little = any(signal.little_endian for signal in message.signals)
+    big = any(not signal.little_endian for signal in message.signals)
+
+    out.append('')
+    out.append('    /**')
+    out.append('     * Decode a payload')
+    out.append('     *')
+    out.append('     * @param[in] data LENGTH bytes of payload')
+    out.append('     * @return The decoded message')
+    out.append('     */')
+    out.append(f'    static constexpr {message.name} unpack('
+               'const uint8_t* data) {')
+    if little:
+        out.append('        uint64_t le = detail::loadLE(data, LENGTH);')
+    if big:
+        out.append('        uint64_t be = detail::loadBE(data, LENGTH);')
+    out.append(f'        {message.name} message;')
+    assignments = []
+    for signal in message.signals:
+        word = 'le' if signal.little_endian else 'be'
+        raw = f'({word} >> {signal.shift()}) & 0x{signal.mask():X}ull'
+        if signal.signed:
+            raw = f'detail::signExtend({raw}, {signal.length})'
+        assignments.append((f'        message.{signal.name}',
+                            f'static_cast<{signal.ctype()}>({raw});'))
+    align(out, assignments)
+    out.append('        return message;')
+    out.append('    }')
+
+    out.append('')
+    out.append('    /**')
+    out.append('     * Encode the message')
+    out.append('     *')
+    out.append('     * @param[out] data LENGTH bytes of payload')
+    out.append('     */')
+    out.append('    constexpr void pack(uint8_t* data) const {')
+    if little:
+        out.append('        uint64_t le = 0;')
+    if big:
+        out.append('        uint64_t be = 0;')
+    for signal in message.signals:
+        word = 'le' if signal.little_endian else 'be'
+        out.append(f'        {word} |= (static_cast<uint64_t>({signal.name})'
+                   f' & 0x{signal.mask():X}ull) << {signal.shift()};')
+    out.append('        detail::zero(data, LENGTH);')
+    if little:
+        out.append('        detail::storeLE(le, data, LENGTH);')
+    if big:
+        out.append('        detail::storeBE(be, data, LENGTH);')
+    out.append('    }')
+
+    out.append('')
+    out.append('    /**')
+    out.append('     * Decode a payload into raw signal values, for tools that '
+               'handle every message alike')
+    out.append('     *')
+    out.append('     * @param[in] data LENGTH bytes of payload')
+    out.append('     * @param[out] raw NUM_SIGNALS values, in member order')
+    out.append('     */')
+    out.append('    static constexpr void unpackRaw(const uint8_t* data, '
+               'int64_t* raw) {')
+    out.append(f'        {message.name} message = unpack(data);')
+    align(out, [(f'        raw[{index}]', f'message.{signal.name};')
+                for index, signal in enumerate(message.signals)])
+    out.append('    }')
+
+    if not message.signals:
+        out.append('};')
+        out.append('')
+        return
+
+    out.append('')
+    out.append('    /**')
+    out.append('     * Check that a message is unchanged by pack() and '
+               'unpack()')
+    out.append('     *')
+    out.append('     * @param[in] message Message to encode and decode')
+    out.append('     * @return Whether every signal decodes to what was '
+               'encoded')
+    out.append('     */')
+    out.append(f'    static constexpr bool roundTrips(const {message.name}& '
+               'message) {')
+    out.append('        uint8_t data[8] = {};')
+    out.append('        message.pack(data);')
+    out.append(f'        {message.name} unpacked = unpack(data);')
+    compares = [f'unpacked.{signal.name} == message.{signal.name}'
+                for signal in message.signals]
+    out.append(f'        return {compares[0]}' +
+               (';' if len(compares) == 1 else ''))
+    for index, compare in enumerate(compares[1:], 2):
+        out.append(f'            && {compare}' +
+                   (';' if index == len(compares) else ''))
+    out.append('    }')
+    out.append('};')
+    out.append('')
+
+    # Every signal at its limits with the others cleared, then every bit set
+    cases = []
+    for index, signal in enumerate(message.signals):
+        for value in signal.limits():
+            values = ['0'] * len(message.signals)
+            values[index] = signal.literal(value)
+            cases.append(values)
+    cases.append([signal.literal(-1 if signal.signed else signal.mask())
+                  for signal in message.signals])
+    for values in cases:
+        out.append(f'static_assert({message.name}::roundTrips'
+                   f'({{{", ".join(values)}}}));')
+    out.append('')
+
+
+def generate(messages, dbc_name):
+    out = []
+    guard = 'TMS_CAN_TMSMESSAGES_HPP'
+    out.append(f'// Generated by tools/dbcgen/dbcgen.py from {dbc_name}. '
+               'Do not edit, regenerate')
+    out.append('// with the can-messages target of the host build instead.')
+    out.append(f'#ifndef {guard}')
+    out.append(f'#define {guard}')
+    out.append('')
+    out.append('#include <cstdint>')
+    out.append('')
+    out.append('namespace TMS::can {')
+    out.append('')
+    out.append(HELPERS)
+
+    for message in messages:
+        generate_message(message, out)
+
+    out.append('/** Every generated message, for tools that look messages '
+               'up by identifier */')
+    out.append('inline constexpr Message MESSAGES[] = {')
+    for message in messages:
+        out.append(f'    {{"{message.name}",')
+        for field in ('ID', 'EXTENDED', 'LENGTH', 'SIGNALS', 'NUM_SIGNALS'):
+            out.append(f'     {message.name}::{field},')
+        out.append(f'     {message.name}::unpackRaw}},')
+    out.append('};')
+    out.append('')
+    out.append('/** Number of entries in MESSAGES */')
+    out.append(f'inline constexpr uint8_t NUM_MESSAGES = {len(messages)};')
+    out.append('')
+    out.append('} // namespace TMS::can')
+    out.append('')
+    out.append(f'#endif // {guard}')
+    return '\n'.join(out) + '\n'
+
+
+HELPERS = '''/**
+ * Layout and scaling of a signal. Physical value = raw * scale + offset.
+ */
+struct Signal {
+    const char* name;
+    const char* unit;
+    /** Start bit as written in the DBC, the MSB for big-endian signals */
+    uint8_t start;
+    uint8_t length;
+    bool littleEndian;
+    bool isSigned;
+    double scale;
+    double offset;
+    double minimum;
+    double maximum;
+};
+
+/**
+ * A generated message, for tools that handle every message alike
+ */
+struct Message {
+    const char* name;
+    uint32_t id;
+    bool extended;
+    uint8_t length;
+    const Signal* signals;
+    uint8_t numSignals;
+    /** Decode a payload into numSignals raw values */
+    void (*unpackRaw)(const uint8_t* data, int64_t* raw);
+};
+
+namespace detail {
+
+/** Payload as a little-endian word, byte 0 in the low bits */
+constexpr uint64_t loadLE(const uint8_t* data, uint8_t length) {
+    uint64_t word = 0;
+    for (uint8_t i = 0; i < length; i++) {
+        word |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+    return word;
+}
+
+/** Payload as a big-endian word, byte 0 in the high bits */
+constexpr uint64_t loadBE(const uint8_t* data, uint8_t length) {
+    uint64_t word = 0;
+    for (uint8_t i = 0; i < length; i++) {
+        word |= static_cast<uint64_t>(data[i]) << (56 - 8 * i);
+    }
+    return word;
+}
+
+/** Merge a little-endian word into the payload */
+constexpr void storeLE(uint64_t word, uint8_t* data, uint8_t length) {
+    for (uint8_t i = 0; i < length; i++) {
+        data[i] |= static_cast<uint8_t>(word >> (8 * i));
+    }
+}
+
+/** Merge a big-endian word into the payload */
+constexpr void storeBE(uint64_t word, uint8_t* data, uint8_t length) {
+    for (uint8_t i = 0; i < length; i++) {
+        data[i] |= static_cast<uint8_t>(word >> (56 - 8 * i));
+    }
+}
+
+/** Clear the payload */
+constexpr void zero(uint8_t* data, uint8_t length) {
+    for (uint8_t i = 0; i < length; i++) {
+        data[i] = 0;
+    }
+}
+
+/** Sign extend the low bits of a raw value */
+constexpr int64_t signExtend(uint64_t raw, uint8_t bits) {
+    uint64_t sign = 1ull << (bits - 1);
+    return static_cast<int64_t>((raw ^ sign) - sign);
+}
+
+static_assert(signExtend(0x7FF, 12) == 2047);
+static_assert(signExtend(0x800, 12) == -2048);
+static_assert(signExtend(0xFFF, 12) == -1);
+static_assert(signExtend(0x1, 1) == -1);
+static_assert(signExtend(0x8000000000000000ull, 64) == INT64_MIN);
+static_assert(signExtend(0xFFFFFFFFFFFFFFFFull, 64) == -1);
+
+} // namespace detail
+'''
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('dbc', help='DBC file to read')
+    parser.add_argument('--output', required=True, help='header to write')
+    parser.add_argument('--message', action='append',
+                        help='message to generate, all by default')
+    parser.add_argument('--check', action='store_true',
+                        help='fail if the header is not up to date instead '
+                             'of writing it')
+    args = parser.parse_args()
+
+    try:
+        messages = parse(args.dbc)
+        names = args.message or list(messages)
+        selected = []
+        for name in names:
+            if name not in messages:
+                raise ValueError(f'{name} is not in {args.dbc}')
+            messages[name].check()
+            selected.append(messages[name])
+    except ValueError as error:
+        print(f'dbcgen: {error}', file=sys.stderr)
+        return 1
+
+    header = generate(selected, os.path.basename(args.dbc))
+    if args.check:
+        try:
+            with open(args.output, encoding='utf-8') as file:
+                current = file.read()
+        except OSError:
+            current = None
+        if current != header:
+            print(f'dbcgen: {args.output} is out of date with {args.dbc}',
+                  file=sys.stderr)
+            return 1
+        return 0
+
+    with open(args.output, 'w', encoding='utf-8') as file:
+        file.write(header)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
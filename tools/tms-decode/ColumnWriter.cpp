@@ -0,0 +1,56 @@
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include "ColumnWriter.hpp"
+
+namespace tmsdecode {
+
+ColumnWriter::ColumnWriter(uint8_t width, size_t chunkBytes) : width(width), chunkBytes(chunkBytes) {}
+
+ColumnWriter::~ColumnWriter() {
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+ColumnWriter::ColumnWriter(ColumnWriter&& other) noexcept
+    : width(other.width), count(other.count), chunkBytes(other.chunkBytes), buffer(std::move(other.buffer)),
+      file(other.file), path(std::move(other.path)), failed(other.failed) {
+    other.file = nullptr;
+}
+
+bool ColumnWriter::open(const std::string& path, std::string& error) {
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    // Values are already written a chunk at a time
+    std::setvbuf(file, nullptr, _IONBF, 0);
+    this->path = path;
+    buffer.reserve(chunkBytes);
+    return true;
+}
+
+void ColumnWriter::flush() {
+    if (!buffer.empty() && file && !failed) {
+        failed = std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size();
+    }
+    buffer.clear();
+}
+
+bool ColumnWriter::close(std::string& error) {
+    flush();
+    if (file) {
+        failed |= std::fclose(file) != 0;
+        file = nullptr;
+    }
+    if (failed) {
+        error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+} // namespace tmsdecode
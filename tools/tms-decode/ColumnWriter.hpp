@@ -0,0 +1,89 @@
+#ifndef TMS_DECODE_COLUMNWRITER_HPP
+#define TMS_DECODE_COLUMNWRITER_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace tmsdecode {
+
+/**
+ * Writes one column of fixed width little-endian integers to its own file. Values are collected in a chunk buffer and
+ * written out a chunk at a time, so the cost of a write is spread over many values and memory use stays bounded
+ * however long the log is.
+ */
+class ColumnWriter {
+public:
+    /**
+     * @param[in] width Size of each value in bytes, 1, 2, 4 or 8
+     * @param[in] chunkBytes Size of the chunk buffer
+     */
+    ColumnWriter(uint8_t width, size_t chunkBytes);
+
+    ~ColumnWriter();
+
+    ColumnWriter(ColumnWriter&& other) noexcept;
+
+    ColumnWriter(const ColumnWriter&) = delete;
+
+    ColumnWriter& operator=(const ColumnWriter&) = delete;
+
+    /**
+     * Create the file of the column
+     *
+     * @param[in] path File to write
+     * @param[out] error Reason the file could not be created
+     * @return Whether the file was created
+     */
+    bool open(const std::string& path, std::string& error);
+
+    /**
+     * Add a value, keeping its low width bytes
+     *
+     * @param[in] value The value
+     */
+    void append(int64_t value) {
+        if (buffer.size() + width > chunkBytes) {
+            flush();
+        }
+        for (uint8_t i = 0; i < width; i++) {
+            buffer.push_back(static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * i)));
+        }
+        count++;
+    }
+
+    /**
+     * Write out the buffered values and close the file
+     *
+     * @param[out] error Reason the values could not be written
+     * @return Whether every value was written
+     */
+    bool close(std::string& error);
+
+    /** Size of each value in bytes */
+    uint8_t width;
+    /** Number of values appended */
+    uint64_t count = 0;
+
+private:
+    /** Size of the chunk buffer */
+    size_t chunkBytes;
+    /** Values not written out yet */
+    std::vector<uint8_t> buffer;
+    /** File of the column */
+    FILE* file = nullptr;
+    /** Path of the file, for errors */
+    std::string path;
+    /** Whether a write failed */
+    bool failed = false;
+
+    /**
+     * Write out the chunk buffer
+     */
+    void flush();
+};
+
+} // namespace tmsdecode
+
+#endif // TMS_DECODE_COLUMNWRITER_HPP
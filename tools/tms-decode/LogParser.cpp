@@ -0,0 +1,176 @@
+#include <cstring>
+
+#include "LogParser.hpp"
+
+namespace tmsdecode {
+
+namespace {
+
+/** Largest valid 11 bit identifier, three hex digits can hold more */
+constexpr uint32_t MAX_STANDARD_ID = 0x7FF;
+
+/** Largest valid 29 bit identifier, candump logs error frames with the error flag above it */
+constexpr uint32_t MAX_EXTENDED_ID = 0x1FFFFFFF;
+
+/** Number of fraction digits that make up a microsecond */
+constexpr int MICROSECOND_DIGITS = 6;
+
+/** Value of each character as a hex digit, -1 for other characters */
+struct HexTable {
+    int8_t values[256];
+
+    constexpr HexTable() : values() {
+        for (int c = 0; c < 256; c++) {
+            if (c >= '0' && c <= '9') {
+                values[c] = static_cast<int8_t>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                values[c] = static_cast<int8_t>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                values[c] = static_cast<int8_t>(c - 'A' + 10);
+            } else {
+                values[c] = -1;
+            }
+        }
+    }
+};
+
+constexpr HexTable HEX;
+
+int hexValue(char c) {
+    return HEX.values[static_cast<uint8_t>(c)];
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool isBlank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+} // namespace
+
+LogParser::LogParser(const char* begin, const char* end) : cursor(begin), end(end) {}
+
+LogParser::Result LogParser::next(LogFrame& frame) {
+    if (cursor >= end) {
+        return Result::END;
+    }
+
+    const char* line    = cursor;
+    const char* newline = static_cast<const char*>(std::memchr(line, '\n', end - line));
+    const char* lineEnd = newline ? newline : end;
+    cursor              = newline ? newline + 1 : end;
+    lines++;
+
+    if (lineEnd > line && lineEnd[-1] == '\r') {
+        lineEnd--;
+    }
+    return parse(line, lineEnd, frame);
+}
+
+LogParser::Result LogParser::parse(const char* p, const char* lineEnd, LogFrame& frame) {
+    while (p < lineEnd && isBlank(*p)) {
+        p++;
+    }
+    if (p == lineEnd) {
+        return Result::SKIPPED;
+    }
+
+    // (seconds.fraction)
+    if (*p++ != '(') {
+        return Result::MALFORMED;
+    }
+    int64_t seconds    = 0;
+    const char* digits = p;
+    while (p < lineEnd && isDigit(*p) && p - digits < 12) {
+        seconds = seconds * 10 + (*p++ - '0');
+    }
+    if (p == digits || p == lineEnd || *p++ != '.') {
+        return Result::MALFORMED;
+    }
+    int64_t fraction   = 0;
+    int fractionDigits = 0;
+    while (p < lineEnd && isDigit(*p)) {
+        if (fractionDigits < MICROSECOND_DIGITS) {
+            fraction = fraction * 10 + (*p - '0');
+            fractionDigits++;
+        }
+        p++;
+    }
+    if (p == lineEnd || *p++ != ')') {
+        return Result::MALFORMED;
+    }
+    for (; fractionDigits < MICROSECOND_DIGITS; fractionDigits++) {
+        fraction *= 10;
+    }
+    frame.timeUs = seconds * 1000000 + fraction;
+
+    // Interface name
+    const char* blanks = p;
+    while (p < lineEnd && isBlank(*p)) {
+        p++;
+    }
+    const char* interface = p;
+    while (p < lineEnd && !isBlank(*p)) {
+        p++;
+    }
+    if (blanks == interface || p == interface) {
+        return Result::MALFORMED;
+    }
+    while (p < lineEnd && isBlank(*p)) {
+        p++;
+    }
+
+    // 3 hex digits for a standard identifier, 8 for an extended one
+    uint32_t id         = 0;
+    const char* idStart = p;
+    int digit;
+    while (p < lineEnd && (digit = hexValue(*p)) >= 0 && p - idStart < 8) {
+        id = id << 4 | static_cast<uint32_t>(digit);
+        p++;
+    }
+    size_t idDigits = p - idStart;
+    if (p == lineEnd || *p++ != '#' || (idDigits != 3 && idDigits != 8)
+        || (idDigits == 3 && id > MAX_STANDARD_ID)) {
+        return Result::MALFORMED;
+    }
+    if (id > MAX_EXTENDED_ID) {
+        return Result::SKIPPED;
+    }
+    frame.id       = id;
+    frame.extended = idDigits == 8;
+
+    // Remote frames are ID#R, CAN FD frames ID##FLAGS
+    if (p < lineEnd && (*p == 'R' || *p == 'r' || *p == '#')) {
+        return Result::SKIPPED;
+    }
+
+    // Data bytes as hex pairs, optionally separated by dots
+    uint8_t dlc = 0;
+    while (p < lineEnd) {
+        if (*p == '.') {
+            p++;
+            continue;
+        }
+        int high = hexValue(*p);
+        if (high < 0) {
+            break;
+        }
+        int low = p + 1 < lineEnd ? hexValue(p[1]) : -1;
+        if (low < 0 || dlc == 8) {
+            return Result::MALFORMED;
+        }
+        frame.data[dlc++] = static_cast<uint8_t>(high << 4 | low);
+        p += 2;
+    }
+    frame.dlc = dlc;
+
+    // Newer candump versions append a _DLC for 8 byte frames with a larger DLC code, or a direction flag
+    if (p < lineEnd && *p != '_' && !isBlank(*p)) {
+        return Result::MALFORMED;
+    }
+    return Result::FRAME;
+}
+
+} // namespace tmsdecode
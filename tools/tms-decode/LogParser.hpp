@@ -0,0 +1,82 @@
+#ifndef TMS_DECODE_LOGPARSER_HPP
+#define TMS_DECODE_LOGPARSER_HPP
+
+#include <cstdint>
+
+namespace tmsdecode {
+
+/**
+ * A classic CAN data frame read from a log
+ */
+struct LogFrame {
+    /** Time the frame was logged, in microseconds since the epoch */
+    int64_t timeUs = 0;
+    /** 11 or 29 bit identifier */
+    uint32_t id = 0;
+    /** Whether id is a 29 bit identifier */
+    bool extended = false;
+    /** Number of data bytes, 0 to 8 */
+    uint8_t dlc = 0;
+    /** Data bytes, only the first dlc are valid */
+    uint8_t data[8] = {};
+};
+
+/**
+ * Reads frames out of a candump log file (candump -l) held in memory, one line at a time:
+ *
+ *     (1436509052.249713) can0 282#0A0B0C0D0E0F1011
+ *
+ * Lines are parsed in place with no allocation or locale-dependent conversions, since a log of a long test can hold
+ * hundreds of millions of frames. Remote frames, error frames and CAN FD frames are skipped.
+ */
+class LogParser {
+public:
+    /** What a line of the log held */
+    enum class Result {
+        /** A data frame */
+        FRAME,
+        /** A blank line or a frame that is not a classic data frame */
+        SKIPPED,
+        /** A line that is not in the candump log format, or a standard identifier above 0x7FF */
+        MALFORMED,
+        /** No lines are left */
+        END,
+    };
+
+    /**
+     * @param[in] begin Start of the log
+     * @param[in] end End of the log
+     */
+    LogParser(const char* begin, const char* end);
+
+    /**
+     * Parse the next line of the log
+     *
+     * @param[out] frame The frame on the line, valid when FRAME is returned
+     * @return What the line held
+     */
+    Result next(LogFrame& frame);
+
+    /** Number of lines read so far */
+    uint64_t lines = 0;
+
+private:
+    /** Start of the next line */
+    const char* cursor;
+    /** End of the log */
+    const char* end;
+
+    /**
+     * Parse one line
+     *
+     * @param[in] p Start of the line
+     * @param[in] lineEnd End of the line, excluding the newline
+     * @param[out] frame The frame on the line
+     * @return What the line held
+     */
+    static Result parse(const char* p, const char* lineEnd, LogFrame& frame);
+};
+
+} // namespace tmsdecode
+
+#endif // TMS_DECODE_LOGPARSER_HPP
@@ -0,0 +1,64 @@
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "MappedFile.hpp"
+
+namespace tmsdecode {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path, std::string& error) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        error = path + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    if (!S_ISREG(status.st_mode)) {
+        error = path + ": not a regular file";
+        ::close(fd);
+        return false;
+    }
+
+    // mmap() rejects empty mappings, an empty file is just an empty range
+    if (status.st_size > 0) {
+        void* mapping = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            error = path + ": " + std::strerror(errno);
+            ::close(fd);
+            return false;
+        }
+        madvise(mapping, static_cast<size_t>(status.st_size), MADV_SEQUENTIAL);
+        data   = static_cast<const char*>(mapping);
+        length = static_cast<size_t>(status.st_size);
+    }
+
+    // The mapping keeps the file referenced
+    ::close(fd);
+    return true;
+}
+
+void MappedFile::close() {
+    if (data) {
+        munmap(const_cast<char*>(data), length);
+    }
+    data   = nullptr;
+    length = 0;
+}
+
+} // namespace tmsdecode
@@ -0,0 +1,61 @@
+#ifndef TMS_DECODE_MAPPEDFILE_HPP
+#define TMS_DECODE_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace tmsdecode {
+
+/**
+ * A file mapped read-only into memory, so a large log can be scanned without copying it through read() buffers.
+ * The kernel is told the file is read sequentially, so it reads ahead and drops pages behind the scan.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Map a file, unmapping any file mapped before
+     *
+     * @param[in] path File to map
+     * @param[out] error Reason the file could not be mapped
+     * @return Whether the file was mapped
+     */
+    bool open(const std::string& path, std::string& error);
+
+    /**
+     * Unmap the file
+     */
+    void close();
+
+    /** Start of the file contents, nullptr for an empty file */
+    const char* begin() const {
+        return data;
+    }
+
+    /** End of the file contents */
+    const char* end() const {
+        return data + length;
+    }
+
+    /** Size of the file in bytes */
+    size_t size() const {
+        return length;
+    }
+
+private:
+    /** Mapped contents */
+    const char* data = nullptr;
+    /** Size of the mapping */
+    size_t length = 0;
+};
+
+} // namespace tmsdecode
+
+#endif // TMS_DECODE_MAPPEDFILE_HPP
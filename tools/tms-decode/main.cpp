@@ -0,0 +1,276 @@
+/**
+ * TMS telemetry decoder. Streams candump logs through memory-mapped I/O, decodes the TMS messages with the pack/unpack
+ * code generated from TMS.dbc that the firmware is checked against, and records each signal as a column of raw values
+ * in its own binary file. A manifest.json next to the columns gives their type, length, scale, offset and unit.
+ *
+ * Usage: tms-decode LOG... --output DIR [--chunk-kb N]
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include <can/TMSMessages.hpp>
+
+#include "ColumnWriter.hpp"
+#include "LogParser.hpp"
+#include "MappedFile.hpp"
+
+namespace can = TMS::can;
+
+namespace {
+
+/** Number of standard identifiers */
+constexpr size_t NUM_STANDARD_IDS = 0x800;
+
+/** Malformed lines reported individually before only being counted */
+constexpr uint64_t MAX_REPORTED_MALFORMED = 5;
+
+void usage(const char* program) {
+    std::fprintf(stderr, "Usage: %s LOG... --output DIR [--chunk-kb N]\n", program);
+}
+
+/** Columns of a decoded message */
+struct Decoded {
+    const can::Message* message;
+    /** Position of the time column in the column list, the signal columns follow it */
+    size_t firstColumn;
+    /** Frames with fewer data bytes than the message */
+    uint64_t shortFrames = 0;
+};
+
+/** Size in bytes of the smallest integer that holds a signal */
+uint8_t widthOf(const can::Signal& signal) {
+    return signal.length <= 8 ? 1 : signal.length <= 16 ? 2 : signal.length <= 32 ? 4 : 8;
+}
+
+/** Write a string as a JSON string */
+void writeString(FILE* file, const char* text) {
+    std::fputc('"', file);
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            std::fputc('\\', file);
+            std::fputc(*c, file);
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            std::fprintf(file, "\\u%04x", *c);
+        } else {
+            std::fputc(*c, file);
+        }
+    }
+    std::fputc('"', file);
+}
+
+void writeColumn(FILE* file, const char* name, const std::string& path, const char* type, const char* unit,
+                 double scale, double offset) {
+    std::fprintf(file, "        {\"name\": ");
+    writeString(file, name);
+    std::fprintf(file, ", \"file\": ");
+    writeString(file, path.c_str());
+    std::fprintf(file, ", \"type\": \"%s\", \"unit\": ", type);
+    writeString(file, unit);
+    std::fprintf(file, ", \"scale\": %.17g, \"offset\": %.17g}", scale, offset);
+}
+
+bool writeManifest(const std::string& path, const std::vector<std::string>& logs, const std::vector<Decoded>& decoded,
+                   const std::vector<tmsdecode::ColumnWriter>& columns) {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+
+    std::fprintf(file, "{\n  \"byte_order\": \"little\",\n  \"sources\": [");
+    for (size_t i = 0; i < logs.size(); i++) {
+        std::fprintf(file, "%s", i ? ", " : "");
+        writeString(file, logs[i].c_str());
+    }
+    std::fprintf(file, "],\n  \"messages\": [");
+    for (size_t m = 0; m < decoded.size(); m++) {
+        const can::Message& message = *decoded[m].message;
+        std::fprintf(file, "%s\n    {\"name\": \"%s\", \"id\": %lu, \"extended\": %s, \"count\": %llu, ", m ? "," : "",
+                     message.name, static_cast<unsigned long>(message.id), message.extended ? "true" : "false",
+                     static_cast<unsigned long long>(columns[decoded[m].firstColumn].count));
+        std::fprintf(file, "\"short_frames\": %llu,\n     \"columns\": [\n",
+                     static_cast<unsigned long long>(decoded[m].shortFrames));
+
+        writeColumn(file, "time_us", std::string(message.name) + ".time_us.bin", "int64", "us", 1, 0);
+        for (uint8_t s = 0; s < message.numSignals; s++) {
+            const can::Signal& signal = message.signals[s];
+            char type[8];
+            std::snprintf(type, sizeof(type), "%sint%d", signal.isSigned ? "" : "u", widthOf(signal) * 8);
+            std::fprintf(file, ",\n");
+            writeColumn(file, signal.name, std::string(message.name) + "." + signal.name + ".bin", type, signal.unit,
+                        signal.scale, signal.offset);
+        }
+        std::fprintf(file, "\n     ]}");
+    }
+    std::fprintf(file, "\n  ]\n}\n");
+    return std::fclose(file) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> logs;
+    std::string outputDir;
+    size_t chunkKb = 256;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue   = i + 1 < argc;
+
+        if (arg[0] != '-') {
+            logs.push_back(arg);
+        } else if (!hasValue) {
+            usage(argv[0]);
+            return 2;
+        } else if (!std::strcmp(arg, "--output")) {
+            outputDir = argv[++i];
+        } else if (!std::strcmp(arg, "--chunk-kb")) {
+            chunkKb = static_cast<size_t>(std::atol(argv[++i]));
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (logs.empty() || outputDir.empty() || chunkKb == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (mkdir(outputDir.c_str(), 0777) != 0 && errno != EEXIST) {
+        std::fprintf(stderr, "Could not create %s: %s\n", outputDir.c_str(), std::strerror(errno));
+        return 1;
+    }
+
+    // One time column and one column per signal for each message, in MESSAGES order
+    std::vector<Decoded> decoded;
+    std::vector<tmsdecode::ColumnWriter> columns;
+    std::string error;
+    for (const can::Message& message : can::MESSAGES) {
+        decoded.push_back({&message, columns.size()});
+        columns.emplace_back(8, chunkKb * 1024);
+        if (!columns.back().open(outputDir + "/" + message.name + ".time_us.bin", error)) {
+            std::fprintf(stderr, "Could not create column: %s\n", error.c_str());
+            return 1;
+        }
+        for (uint8_t s = 0; s < message.numSignals; s++) {
+            const can::Signal& signal = message.signals[s];
+            columns.emplace_back(widthOf(signal), chunkKb * 1024);
+            if (!columns.back().open(outputDir + "/" + message.name + "." + signal.name + ".bin", error)) {
+                std::fprintf(stderr, "Could not create column: %s\n", error.c_str());
+                return 1;
+            }
+        }
+    }
+
+    // Standard identifiers are looked up directly, extended ones by searching the few extended messages
+    int16_t standard[NUM_STANDARD_IDS];
+    std::fill(standard, standard + NUM_STANDARD_IDS, -1);
+    for (size_t m = 0; m < decoded.size(); m++) {
+        if (!decoded[m].message->extended) {
+            standard[decoded[m].message->id] = static_cast<int16_t>(m);
+        }
+    }
+
+    uint64_t bytes     = 0;
+    uint64_t lines     = 0;
+    uint64_t frames    = 0;
+    uint64_t recorded  = 0;
+    uint64_t skipped   = 0;
+    uint64_t malformed = 0;
+    int64_t raw[64];
+    auto start = std::chrono::steady_clock::now();
+
+    for (const std::string& log : logs) {
+        tmsdecode::MappedFile file;
+        if (!file.open(log, error)) {
+            std::fprintf(stderr, "Could not read log: %s\n", error.c_str());
+            return 1;
+        }
+        bytes += file.size();
+
+        tmsdecode::LogParser parser(file.begin(), file.end());
+        tmsdecode::LogFrame frame;
+        tmsdecode::LogParser::Result result;
+        while ((result = parser.next(frame)) != tmsdecode::LogParser::Result::END) {
+            if (result == tmsdecode::LogParser::Result::SKIPPED) {
+                skipped++;
+                continue;
+            }
+            if (result == tmsdecode::LogParser::Result::MALFORMED) {
+                if (malformed++ < MAX_REPORTED_MALFORMED) {
+                    std::fprintf(stderr, "%s:%llu: not a candump log line\n", log.c_str(),
+                                 static_cast<unsigned long long>(parser.lines));
+                }
+                continue;
+            }
+            frames++;
+
+            int index = -1;
+            if (!frame.extended) {
+                index = frame.id < NUM_STANDARD_IDS ? standard[frame.id] : -1;
+            } else {
+                for (size_t m = 0; m < decoded.size(); m++) {
+                    if (decoded[m].message->extended && decoded[m].message->id == frame.id) {
+                        index = static_cast<int>(m);
+                        break;
+                    }
+                }
+            }
+            if (index < 0) {
+                continue;
+            }
+
+            Decoded& entry              = decoded[index];
+            const can::Message& message = *entry.message;
+            if (frame.dlc < message.length) {
+                entry.shortFrames++;
+                continue;
+            }
+            message.unpackRaw(frame.data, raw);
+            columns[entry.firstColumn].append(frame.timeUs);
+            for (uint8_t s = 0; s < message.numSignals; s++) {
+                columns[entry.firstColumn + 1 + s].append(raw[s]);
+            }
+            recorded++;
+        }
+        lines += parser.lines;
+    }
+
+    bool ok = true;
+    for (tmsdecode::ColumnWriter& column : columns) {
+        if (!column.close(error)) {
+            std::fprintf(stderr, "Could not write column: %s\n", error.c_str());
+            ok = false;
+        }
+    }
+    std::string manifest = outputDir + "/manifest.json";
+    if (!writeManifest(manifest, logs, decoded, columns)) {
+        std::fprintf(stderr, "Could not write %s\n", manifest.c_str());
+        ok = false;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("Read %llu lines, %.1f MB from %zu logs in %.3f s: %.1f MB/s, %.2f M lines/s\n",
+                static_cast<unsigned long long>(lines), static_cast<double>(bytes) / 1e6, logs.size(), seconds,
+                static_cast<double>(bytes) / 1e6 / seconds, static_cast<double>(lines) / 1e6 / seconds);
+    std::printf("%llu frames, %llu TMS messages recorded, %llu lines skipped, %llu malformed\n",
+                static_cast<unsigned long long>(frames), static_cast<unsigned long long>(recorded),
+                static_cast<unsigned long long>(skipped), static_cast<unsigned long long>(malformed));
+    for (size_t m = 0; m < decoded.size(); m++) {
+        std::printf("%-16s 0x%03lX %llu recorded", decoded[m].message->name,
+                    static_cast<unsigned long>(decoded[m].message->id),
+                    static_cast<unsigned long long>(columns[decoded[m].firstColumn].count));
+        if (decoded[m].shortFrames) {
+            std::printf(", %llu too short", static_cast<unsigned long long>(decoded[m].shortFrames));
+        }
+        std::printf("\n");
+    }
+    return ok ? 0 : 1;
+}